@@ -0,0 +1,125 @@
+#ifndef __AUGMENT_MARK__
+#define __AUGMENT_MARK__
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file Augment.h
+ * @brief AVL 树的增强策略 (Augment policy)
+ *
+ * 增强策略是元素类型 T 上的一个幺半群：每个节点额外存放一个聚合值，等于它的子树中
+ * 所有元素按中序 "相加" 的结果。BinarySearchTree 在每次重新计算节点高度时 (balance、旋转、
+ * 批量建树之后) 都用左右子树的聚合值和节点自己的元素在 O(1) 时间内重新算出它，
+ * 所以插入、删除和四种旋转之后聚合值始终正确，区间聚合查询只需要 O(log n)。
+ *
+ * 一个策略是一个以元素类型为参数的类模板，需要提供：
+ * - value_type: 聚合值的类型;
+ * - enabled: 为 false 时节点中不存放聚合值 (见 NoAugment);
+ * - identity(): 幺元，空子树的聚合值;
+ * - of(x): 单个元素的聚合值;
+ * - combine(a, b): 满足结合律的二元运算，a 在中序中位于 b 之前，不要求交换律。
+ * 另外提供 count(v) 把聚合值换算成元素个数的策略，可以使用 select、rank 等按名次的查询。
+ */
+
+/**
+ * @brief 默认的策略：不做任何增强，节点中不存放聚合值，也不占空间
+ */
+template <typename T>
+struct NoAugment
+{
+    struct value_type { };
+    static constexpr bool enabled = false;
+    static value_type identity() { return { }; }
+    static value_type of(const T &) { return { }; }
+    static value_type combine(const value_type &, const value_type &) { return { }; }
+};
+
+/**
+ * @brief 子树大小，用于按名次查找 (顺序统计树)
+ */
+template <typename T>
+struct OrderStatistics
+{
+    using value_type = int;
+    static constexpr bool enabled = true;
+    static value_type identity() { return 0; }
+    static value_type of(const T &) { return 1; }
+    static value_type combine(value_type a, value_type b) { return a + b; }
+    static int count(value_type v) { return v; }
+};
+
+/**
+ * @brief 子树中元素的和，T 需要支持 + 并且 T{} 为零
+ */
+template <typename T>
+struct SubtreeSum
+{
+    using value_type = T;
+    static constexpr bool enabled = true;
+    static value_type identity() { return T{ }; }
+    static value_type of(const T &x) { return x; }
+    static value_type combine(const value_type &a, const value_type &b) { return a + b; }
+};
+
+/**
+ * @brief 子树中的最小元素。树按 < 排序，所以它就是最左边的元素，这里主要用作例子，
+ * 以及在元素的比较方式和取最小的方式不同时使用
+ */
+template <typename T>
+struct SubtreeMin
+{
+    using value_type = T;
+    static constexpr bool enabled = true;
+    static value_type identity() { return std::numeric_limits<T>::max(); }
+    static value_type of(const T &x) { return x; }
+    static value_type combine(const value_type &a, const value_type &b) { return b < a ? b : a; }
+};
+
+/**
+ * @brief 子树中的最大元素
+ */
+template <typename T>
+struct SubtreeMax
+{
+    using value_type = T;
+    static constexpr bool enabled = true;
+    static value_type identity() { return std::numeric_limits<T>::lowest(); }
+    static value_type of(const T &x) { return x; }
+    static value_type combine(const value_type &a, const value_type &b) { return a < b ? b : a; }
+};
+
+/**
+ * @brief 节点中存放聚合值的部分，作为节点的基类。策略没有打开时是空类，不占空间
+ *
+ * @tparam A 增强策略
+ */
+template <typename A, bool = A::enabled>
+struct AugmentField
+{
+    typename A::value_type value = A::identity();   ///< 子树的聚合值
+};
+
+template <typename A>
+struct AugmentField<A, false>
+{
+};
+
+/**
+ * @brief 策略是否提供 count，也就是能否按名次查询
+ */
+template <typename A, typename = void>
+struct CountsElements : std::false_type
+{
+};
+
+template <typename A>
+struct CountsElements<A, std::void_t<decltype(A::count(std::declval<const typename A::value_type &>()))>>
+    : std::true_type
+{
+};
+
+#else
+// DO NOTHING.
+#endif
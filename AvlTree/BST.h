@@ -9,10 +9,20 @@
  * 
  */
 
+#ifndef __BST_MARK__
+#define __BST_MARK__
+
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 #ifdef _WIN32
 #include <windows.h>    // SetConsoleOutputCP
 #endif
+#include "Augment.h"
 
 /// 临时性的异常类，用于表示树为空的异常
 class UnderflowException { };
@@ -26,11 +36,154 @@ class IteratorUninitializedException { };
  * @brief 二叉搜索树模板类
  * 
  * @tparam Comparable 模板参数，表示树中存储的元素类型
+ * @tparam Augment 增强策略 (见 Augment.h)，每个节点维护子树的聚合值，aggregate 可以在 O(log n)
+ * 时间内求出任意区间的聚合值。缺省的 NoAugment 不占空间；OrderStatistics 维护子树大小，
+ * 打开后 select、rank、count_in_range 和 size 都是 O(log n) 或 O(1) 的
  */
-template <typename Comparable>
+template <typename Comparable, template <typename> class Augment = NoAugment>
 class BinarySearchTree
 {
 public:
+    using AugmentPolicy = Augment<Comparable>;
+    using AugmentValue = typename AugmentPolicy::value_type;
+
+protected:
+    struct BinaryNode;  // 迭代器中要用到，定义在后面
+
+public:
+    /**
+     * @brief 中序遍历的只读双向迭代器
+     * 
+     * 节点里存有父指针，所以不需要栈：有右子树时 ++ 走到右子树的最左节点，否则沿父指针向上，
+     * 直到从某个节点的左子树上来，-- 与之对称。每条边最多向下、向上各走一次，所以遍历整棵树是
+     * O(n) 的，单次 ++ 均摊 O(1)。元素决定了节点在树中的位置，因此不能通过迭代器修改元素。
+     * 
+     * 插入不会使迭代器失效；删除只使指向被删元素的迭代器失效，其它节点只是被重新链接，不会被移动。
+     */
+    class const_iterator
+    {
+    public:
+        /// 标准库的算法通过 std::iterator_traits 读取这几个类型
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Comparable;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Comparable *;
+        using reference = const Comparable &;
+
+        /**
+         * @brief 默认构造函数，得到一个未初始化的迭代器，使用它会抛出 IteratorUninitializedException
+         */
+        const_iterator() : current{ nullptr }, tree{ nullptr } {}
+
+        /**
+         * @brief 返回当前元素，对 end() 解引用抛出 IteratorOutOfBoundsException
+         * 
+         * @return 当前元素的常量引用
+         */
+        const Comparable &operator*() const {
+            assertIsValid();
+            if (current == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            return current->element;
+        }
+
+        const Comparable *operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief 移到中序的下一个元素，end() 不能再向后移
+         * 
+         * @return 自身的引用
+         */
+        const_iterator &operator++() {
+            assertIsValid();
+            if (current == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            if (current->right != nullptr) {
+                /// 右子树中最小的元素
+                current = current->right;
+                while (current->left != nullptr)
+                    current = current->left;
+            } else {
+                /// 向上，直到从某个节点的左子树上来，那个节点就是下一个；走到根之上就是 end()
+                const BinaryNode *child = current;
+                current = current->parent;
+                while (current != nullptr && current->right == child) {
+                    child = current;
+                    current = current->parent;
+                }
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        /**
+         * @brief 移到中序的前一个元素。end() 的前一个是最大元素，begin() 不能再向前移
+         * 
+         * @return 自身的引用
+         */
+        const_iterator &operator--() {
+            assertIsValid();
+            const BinaryNode *p = current;
+            if (p == nullptr) {
+                p = tree->findMax(tree->root);
+            } else if (p->left != nullptr) {
+                /// 左子树中最大的元素
+                p = p->left;
+                while (p->right != nullptr)
+                    p = p->right;
+            } else {
+                const BinaryNode *child = p;
+                p = p->parent;
+                while (p != nullptr && p->left == child) {
+                    child = p;
+                    p = p->parent;
+                }
+            }
+            /// 空树的 end()，或者已经是 begin()
+            if (p == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            current = p;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return current == rhs.current;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+    protected:
+        const BinaryNode *current;      ///< 当前节点，end() 为 nullptr
+        const BinarySearchTree *tree;   ///< 所属的树，从 end() 向前移时要用到
+
+        const_iterator(const BinaryNode *p, const BinarySearchTree *t) : current{ p }, tree{ t } {}
+
+        void assertIsValid() const {
+            if (tree == nullptr)
+                throw IteratorUninitializedException{ };
+        }
+
+        friend class BinarySearchTree;
+    };
+
+    /// 元素不能通过迭代器修改，所以 iterator 和 const_iterator 是同一个类型
+    using iterator = const_iterator;
+
     /**
      * @brief 默认构造函数
      * 
@@ -72,7 +225,7 @@ public:
     /**
      * @brief 查找并返回树中的最小元素
      * 
-     * 这是一个公有接口，它调用了私有的递归函数。
+     * 这是一个公有接口，它调用了私有的同名函数。
      * 
      * @return 最小元素的引用
      */
@@ -103,6 +256,204 @@ public:
         return contains(x, root);
     }
 
+    /**
+     * @brief 指向最小元素的迭代器，空树时等于 end()
+     */
+    const_iterator begin() const {
+        return { findMin(root), this };
+    }
+
+    /**
+     * @brief 最大元素之后的位置
+     */
+    const_iterator end() const {
+        return { nullptr, this };
+    }
+
+    /**
+     * @brief 第一个不小于 x 的元素，O(树高)
+     * 
+     * @param x 要比较的值
+     * @return 指向该元素的迭代器，不存在时为 end()
+     */
+    const_iterator lower_bound(const Comparable &x) const {
+        BinaryNode *t = root;
+        BinaryNode *result = nullptr;
+        while (t != nullptr) {
+            if (t->element < x) {
+                t = t->right;
+            } else {
+                result = t;     // t 是一个候选，更小的候选只可能在左子树中
+                t = t->left;
+            }
+        }
+        return { result, this };
+    }
+
+    /**
+     * @brief 第一个大于 x 的元素，O(树高)
+     * 
+     * @param x 要比较的值
+     * @return 指向该元素的迭代器，不存在时为 end()
+     */
+    const_iterator upper_bound(const Comparable &x) const {
+        BinaryNode *t = root;
+        BinaryNode *result = nullptr;
+        while (t != nullptr) {
+            if (x < t->element) {
+                result = t;
+                t = t->left;
+            } else {
+                t = t->right;
+            }
+        }
+        return { result, this };
+    }
+
+    /**
+     * @brief 按从小到大的顺序对闭区间 [lo, hi] 中的每个元素调用 f
+     * 
+     * 先用 lower_bound 找到起点，再逐个 ++ 直到超过 hi。区间外的子树都不会被访问，
+     * 总共访问 O(树高 + k) 个节点，k 为区间中的元素个数，不需要把整棵树拷贝出来。
+     * 
+     * @param lo 区间下界
+     * @param hi 区间上界
+     * @param f 以 const Comparable & 为参数的函数
+     */
+    template <typename Function>
+    void for_each_in_range(const Comparable &lo, const Comparable &hi, Function f) const {
+        for (const_iterator it = lower_bound(lo); it.current != nullptr && !(hi < it.current->element); ++it) {
+            f(it.current->element);
+        }
+    }
+
+    /**
+     * @brief 树中的元素个数，O(1)。只有增强策略能计数 (如 OrderStatistics) 时可用
+     * 
+     * @return 元素个数
+     */
+    int size() const {
+        static_assert(CountsElements<AugmentPolicy>::value, "size() needs an augment policy with count(), e.g. OrderStatistics");
+        return subtreeSize(root);
+    }
+
+    /**
+     * @brief 第 k 小的元素 (从 0 开始数)，O(log n)。只有增强策略能计数 (如 OrderStatistics) 时可用
+     * 
+     * 比较 k 和左子树的大小就知道该向哪边走，不需要中序遍历前 k 个元素。
+     * 
+     * @param k 名次，不在 [0, size()) 中时抛出 ArrayIndexOutOfBoundsException
+     * @return 第 k 小的元素
+     */
+    const Comparable &select(int k) const {
+        static_assert(CountsElements<AugmentPolicy>::value, "select() needs an augment policy with count(), e.g. OrderStatistics");
+        if (k < 0 || k >= subtreeSize(root)) {
+            throw ArrayIndexOutOfBoundsException{ };
+        }
+        BinaryNode *t = root;
+        for (;;) {
+            int l = subtreeSize(t->left);
+            if (k < l) {
+                t = t->left;
+            } else if (k == l) {
+                return t->element;
+            } else {
+                k -= l + 1;     // 跳过左子树和 t 本身
+                t = t->right;
+            }
+        }
+    }
+
+    /**
+     * @brief 树中小于 x 的元素个数，也就是 x 在树中时的名次，O(log n)。只有增强策略能计数 (如 OrderStatistics) 时可用
+     * 
+     * @param x 要比较的值，不必在树中
+     * @return 小于 x 的元素个数
+     */
+    int rank(const Comparable &x) const {
+        static_assert(CountsElements<AugmentPolicy>::value, "rank() needs an augment policy with count(), e.g. OrderStatistics");
+        return countBelow(x, false);
+    }
+
+    /**
+     * @brief 闭区间 [lo, hi] 中的元素个数，O(log n)。只有增强策略能计数 (如 OrderStatistics) 时可用
+     * 
+     * 不逐个访问区间中的元素 (那是 for_each_in_range 的 O(log n + k))，而是用两次 rank 相减。
+     * 
+     * @param lo 区间下界
+     * @param hi 区间上界
+     * @return 区间中的元素个数，hi < lo 时为 0
+     */
+    int count_in_range(const Comparable &lo, const Comparable &hi) const {
+        static_assert(CountsElements<AugmentPolicy>::value, "count_in_range() needs an augment policy with count(), e.g. OrderStatistics");
+        if (hi < lo) {
+            return 0;
+        }
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
+    /**
+     * @brief 整棵树的聚合值，也就是根节点中存的值，O(1)。空树时为幺元
+     * 
+     * @return 所有元素按从小到大的顺序 combine 的结果
+     */
+    AugmentValue aggregate() const {
+        static_assert(AugmentPolicy::enabled, "aggregate() needs an augment policy");
+        return subtreeValue(root);
+    }
+
+    /**
+     * @brief 闭区间 [lo, hi] 中所有元素按从小到大的顺序 combine 的结果，O(log n)
+     * 
+     * 先向下找到第一个落在区间中的节点 s，区间中的元素都在以 s 为根的子树里。然后沿着 lo 在
+     * s 的左子树中的查找路径往下走：节点不小于 lo 时，它和它的右子树整个在区间中，
+     * 直接用右子树存好的聚合值，不必再往里走；右边界对称。两条路径都不超过树高，
+     * 每一步只做常数次 combine。因为 combine 不要求交换律，左边界上的值要拼在已有结果的前面。
+     * 
+     * @param lo 区间下界
+     * @param hi 区间上界
+     * @return 区间的聚合值，区间中没有元素 (包括 hi < lo) 时为幺元
+     */
+    AugmentValue aggregate(const Comparable &lo, const Comparable &hi) const {
+        static_assert(AugmentPolicy::enabled, "aggregate() needs an augment policy");
+        BinaryNode *s = root;
+        while (s != nullptr) {
+            if (s->element < lo) {
+                s = s->right;
+            } else if (hi < s->element) {
+                s = s->left;
+            } else {
+                break;
+            }
+        }
+        if (s == nullptr) {
+            return AugmentPolicy::identity();
+        }
+        /// s 左边不小于 lo 的部分
+        AugmentValue left = AugmentPolicy::identity();
+        for (BinaryNode *t = s->left; t != nullptr; ) {
+            if (t->element < lo) {
+                t = t->right;
+            } else {
+                left = AugmentPolicy::combine(AugmentPolicy::of(t->element),
+                                              AugmentPolicy::combine(subtreeValue(t->right), left));
+                t = t->left;
+            }
+        }
+        /// s 右边不大于 hi 的部分
+        AugmentValue right = AugmentPolicy::identity();
+        for (BinaryNode *t = s->right; t != nullptr; ) {
+            if (hi < t->element) {
+                t = t->left;
+            } else {
+                right = AugmentPolicy::combine(AugmentPolicy::combine(right, subtreeValue(t->left)),
+                                               AugmentPolicy::of(t->element));
+                t = t->right;
+            }
+        }
+        return AugmentPolicy::combine(left, AugmentPolicy::combine(AugmentPolicy::of(s->element), right));
+    }
+
     /**
      * @brief 检查树是否为空
      * 
@@ -136,6 +487,55 @@ public:
         makeEmpty(root);
     }
 
+    /**
+     * @brief 由有序序列直接建一棵高度最小的树
+     * 
+     * 有序的数据逐个 insert 会退化成一条链，建树要 O(n^2)。这里先把元素依次接成一条
+     * 只有右子节点的链 (vine)，再用 DSW 算法的几轮左旋把它压成平衡的树，总共 O(n)，
+     * 除了节点本身不需要额外的空间。相等的相邻元素只保留第一个，和 insert 一样不存重复元素。
+     * 
+     * @tparam Iterator 输入迭代器，元素必须按 < 非降序排列，否则抛出 IllegalArgumentException
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return 建好的树
+     */
+    template <typename Iterator>
+    static BinarySearchTree from_sorted(Iterator first, Iterator last) {
+        BinarySearchTree tree;
+        BinaryNode **tail = &tree.root;
+        BinaryNode *prev = nullptr;
+        int n = 0;
+        /// 中途抛出异常时，已经接上的节点仍然是一棵合法的树，随 tree 一起析构
+        for (; first != last; ++first) {
+            if (prev != nullptr && !(prev->element < *first)) {
+                if (*first < prev->element) {
+                    throw IllegalArgumentException{ };
+                }
+                continue;   // 重复的元素
+            }
+            *tail = prev = new BinaryNode{*first, nullptr, nullptr};
+            tail = &prev->right;
+            ++n;
+        }
+        vineToTree(tree.root, n);
+        fixParents(tree.root);
+        tree.fixHeights(tree.root);
+        return tree;
+    }
+
+    /**
+     * @brief 把现有的树原地整理成高度最小的树
+     * 
+     * 先用右旋把树拉直成一条链，再像 from_sorted 一样压回平衡的树。只修改指针，
+     * 不分配也不释放节点，元素不会被拷贝或移动，O(n) 时间。最后重新设置父指针时
+     * 用到一个深度为 O(log n) 的栈。
+     */
+    void rebuild() {
+        vineToTree(root, treeToVine(root));
+        fixParents(root);
+        fixHeights(root);
+    }
+
     /**
      * @brief 插入一个常量引用元素到树中
      * 
@@ -197,12 +597,13 @@ protected:
     /**
      * @brief 二叉树节点结构体
      */
-    struct BinaryNode
+    struct BinaryNode : AugmentField<AugmentPolicy>
     {
         Comparable element;  ///< 节点存储的元素
         BinaryNode *left;    ///< 左子节点指针
         BinaryNode *right;   ///< 右子节点指针
         int        height;   ///< 子树高度
+        BinaryNode *parent = nullptr;  ///< 父节点指针，根节点为 nullptr，供迭代器向上走
 
         /**
          * @brief 构造函数，接受常量引用
@@ -213,7 +614,9 @@ protected:
          * @param h 子树高度，缺省为0 
          */
         BinaryNode(const Comparable &theElement, BinaryNode *lt, BinaryNode *rt, int h = 0 )
-            : element{ theElement }, left{ lt }, right{ rt }, height{ h } {}
+            : element{ theElement }, left{ lt }, right{ rt }, height{ h } {
+            initValue();
+        }
 
         /**
          * @brief 构造函数，接受右值引用
@@ -224,13 +627,21 @@ protected:
          * @param h 子树高度，缺省为0 
          */
         BinaryNode(Comparable &&theElement, BinaryNode *lt, BinaryNode *rt, int h = 0 )
-            : element{ std::move(theElement) }, left{ lt }, right{ rt }, height{ h } {}
+            : element{ std::move(theElement) }, left{ lt }, right{ rt }, height{ h } {
+            initValue();
+        }
+
+        /// 新节点没有子树，聚合值就是它自己的元素
+        void initValue() {
+            if constexpr (AugmentPolicy::enabled)
+                this->value = AugmentPolicy::of(element);
+        }
     };
 
     BinaryNode *root;  ///< 树的根节点指针
 
     /**
-     * @brief 递归查找最小元素
+     * @brief 查找最小元素
      * 
      * @param t 当前节点指针
      * @return 最小元素所在的节点指针
@@ -240,23 +651,21 @@ protected:
         if (t == nullptr) {
             return nullptr;
         }
-        /// 向左无路了，当前节点就是最小元素
-        if (t->left == nullptr) {
-            return t;
+        /// 一直向左，直到向左无路，那个节点就是最小元素
+        while (t->left != nullptr) {
+            t = t->left;
         }
-        /// 否则继续向左查找
-        return findMin(t->left);
+        return t;
     }
 
     /**
-     * @brief 递归查找最大元素
+     * @brief 查找最大元素
      * 
      * @param t 当前节点指针
      * @return 最大元素所在的节点指针
      */
     BinaryNode *findMax(BinaryNode *t) const {
-        /// 这里没有使用递归，而是使用循环，更高效
-        /// findMin 也可以改成循环实现
+        /// 和 findMin 一样用循环，不用递归
         if (t != nullptr) {
             while (t->right != nullptr) {
                 t = t->right;
@@ -266,26 +675,26 @@ protected:
     }
 
     /**
-     * @brief 递归检查树中是否包含指定的元素
+     * @brief 检查树中是否包含指定的元素
      * 
      * @param x 要查找的元素
      * @param t 当前节点指针
      * @return 如果树中包含该元素，则返回 true；否则返回 false
      */
     bool contains(const Comparable &x, BinaryNode *t) const {
-        /// 这是递归版本，也可以有循环版本
-        if (t == nullptr) {
-            return false;
-        }
-        if (x < t->element) {
-            return contains(x, t->left);
-        } 
-        else if (x > t->element) {
-            return contains(x, t->right);
-        } 
-        else {
-            return true;  // 找到元素
+        /// 递归版本的每一层只是换一个 t 继续比较，直接写成循环
+        while (t != nullptr) {
+            if (x < t->element) {
+                t = t->left;
+            } 
+            else if (x > t->element) {
+                t = t->right;
+            } 
+            else {
+                return true;  // 找到元素
+            }
         }
+        return false;
     }
 
     /**
@@ -312,6 +721,8 @@ protected:
     * @param prePrint 前导输出
     * @param numofChild 当前输出为父节点的第几个子节点
     * @param noBrother 是否有兄弟节点
+    *
+    * 这里仍然是递归的，但递归深度就是树高，AVL 树的高度不超过 1.44 log n，不会爆栈。
     */
     void printTree(BinaryNode *t, std::ostream &out, std::string prePrint = "", int numofChild = 1, bool noBrother = 1) const {
         #ifdef _WIN32
@@ -343,124 +754,285 @@ protected:
 
 
     /**
-     * @brief 递归清空树中的所有元素
+     * @brief 清空树中的所有元素
+     * 
+     * 递归版本必须是后序遍历：先删子树再删自己，否则删掉 t 之后就找不到它的子树了。
+     * 这里不需要栈：t 有左子树时先右旋一次，把左子节点转上来；没有左子树时 t 就可以删了，
+     * 接着处理它的右子树。反正整棵树都要删掉，旋转时不必维护高度。
+     * 它不访问树本身的成员，所以是静态的，const 的 clone 也可以用它回收拷贝了一半的节点。
      * 
      * @param t 当前节点指针
      */
-    void makeEmpty(BinaryNode * &t) {
-        /// 这必须是一个后序遍历，为什么？
-        if (t != nullptr) {
-            makeEmpty(t->left);
-            makeEmpty(t->right);
-            delete t;
-            /// delete 并不会自动将指针置空，这里需要手动置空
-            t = nullptr;
+    static void makeEmpty(BinaryNode * &t) {
+        while (t != nullptr) {
+            if (t->left != nullptr) {
+                BinaryNode *l = t->left;
+                t->left = l->right;
+                l->right = t;
+                t = l;
+            } else {
+                BinaryNode *r = t->right;
+                delete t;
+                t = r;
+            }
+        }
+        /// 循环结束时 t 已经是 nullptr 了
+    }
+
+    /**
+     * @brief 用右旋把以 t 为根的树拉直成一条只有右子节点的链 (vine)，元素的顺序不变
+     * 
+     * @param t 当前节点指针
+     * @return 节点个数
+     */
+    static int treeToVine(BinaryNode * &t) {
+        int n = 0;
+        BinaryNode **p = &t;
+        while (*p != nullptr) {
+            if ((*p)->left != nullptr) {
+                /// 左子节点转上来，原来的节点成为它的右子节点
+                BinaryNode *l = (*p)->left;
+                (*p)->left = l->right;
+                l->right = *p;
+                *p = l;
+            } else {
+                ++n;
+                p = &(*p)->right;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief 从链头开始，每隔一个节点做一次左旋，共做 count 次，链的长度大约减半
+     * 
+     * @param t 链头指针
+     * @param count 左旋次数
+     */
+    static void compress(BinaryNode * &t, int count) {
+        BinaryNode **p = &t;
+        for (int i = 0; i < count; ++i) {
+            BinaryNode *child = *p;
+            BinaryNode *r = child->right;
+            child->right = r->left;
+            r->left = child;
+            *p = r;
+            p = &r->right;
+        }
+    }
+
+    /**
+     * @brief DSW 算法的第二步：把长为 n 的链压成平衡的树
+     * 
+     * 先把多出满二叉树 (2^k - 1 个节点) 的那些节点压到最底层，剩下的正好是满二叉树的形状，
+     * 每一轮压缩让链的长度减半，最后所有叶子的深度至多相差 1，树高为 floor(log2 n)。
+     * 
+     * @param t 链头指针
+     * @param n 节点个数
+     */
+    static void vineToTree(BinaryNode * &t, int n) {
+        int full = 1;
+        while (full * 2 + 1 <= n) {
+            full = full * 2 + 1;
+        }
+        compress(t, n - full);
+        for (int m = full / 2; m > 0; m /= 2) {
+            compress(t, m);
+        }
+    }
+
+    /**
+     * @brief 重新设置以 t 为根的整棵树的父指针，t 的父指针置为 nullptr
+     * 
+     * 拉直和压缩时旋转得太多，逐个维护父指针不如最后统一设置一遍。只在树已经平衡之后调用，
+     * 栈的深度不超过树高。
+     * 
+     * @param t 根节点指针
+     */
+    static void fixParents(BinaryNode *t) {
+        if (t == nullptr) {
+            return;
+        }
+        t->parent = nullptr;
+        std::vector<BinaryNode *> stack{ t };
+        while (!stack.empty()) {
+            BinaryNode *n = stack.back();
+            stack.pop_back();
+            for (BinaryNode *c : { n->left, n->right }) {
+                if (c != nullptr) {
+                    c->parent = n;
+                    stack.push_back(c);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 后序遍历，自底向上重新计算每个节点的高度 (以及聚合值)
+     * 
+     * 只在 from_sorted 和 rebuild 之后调用，那时树已经平衡，栈的深度不超过 log n。
+     * 
+     * @param t 子树根节点指针
+     */
+    void fixHeights(BinaryNode *t) {
+        std::vector<BinaryNode *> stack;
+        BinaryNode *last = nullptr;  // 上一个算好高度的节点
+        while (t != nullptr || !stack.empty()) {
+            if (t != nullptr) {
+                stack.push_back(t);
+                t = t->left;
+            } else {
+                BinaryNode *top = stack.back();
+                if (top->right != nullptr && top->right != last) {
+                    t = top->right;  // 右子树还没有处理
+                } else {
+                    update( top );
+                    last = top;
+                    stack.pop_back();
+                }
+            }
         }
     }
 
     /**
-     * @brief 递归插入一个常量引用元素到树中
+     * @brief 从 t 向下找 x 应该在的位置，并记下沿途经过的指针
+     * 
+     * 递归版本传下去的是父节点里左指针或右指针的引用，返回时再逐层 balance。
+     * 这里用指向这些指针的指针代替，把它们按从上到下的顺序存进 path，之后倒着 balance 一遍，
+     * 效果和递归返回时完全一样。旋转只改变这些指针的值，不改变它们所在的位置，所以 path 一直有效。
+     * 
+     * @param x 要查找的元素
+     * @param t 子树根节点指针的引用
+     * @param path 沿途经过的指针，不包括返回的那一个
+     * @return 指向 x 所在节点的那个指针；x 不存在时，是 x 插入后应该挂上去的那个空指针
+     */
+    BinaryNode **findSlot(const Comparable &x, BinaryNode * &t, std::vector<BinaryNode **> &path) {
+        BinaryNode **p = &t;
+        while (*p != nullptr) {
+            if (x < (*p)->element) {
+                path.push_back(p);
+                p = &(*p)->left;
+            } else if (x > (*p)->element) {
+                path.push_back(p);
+                p = &(*p)->right;
+            } else {
+                break;  // 找到元素
+            }
+        }
+        return p;
+    }
+
+    /**
+     * @brief 从下往上 balance path 中的每一个节点，相当于递归版本逐层返回
+     * 
+     * @param path findSlot 记下的指针
+     */
+    void balancePath(const std::vector<BinaryNode **> &path) {
+        for (auto i = path.rbegin(); i != path.rend(); ++i)
+            balance(**i);
+    }
+
+    /**
+     * @brief 插入一个常量引用元素到树中
      * 
      * @param x 要插入的元素
      * @param t 当前节点指针
      */
     void insert(const Comparable &x, BinaryNode * &t) {
-        /// 这句话乍一看不可思异，怎么能对一个空指针赋值呢？
-        /// 但是这里是引用，所以实际上是对指针 t 的引用，t 现在存了 nullptr, 
-        /// 所以可以修改指针 t 的值
-        if (t == nullptr) {
-            /// 创建一个新节点，包含 x 的值，左右子节点为空
-            /// 挂在 t 指向的节点上
-            /// 而在递归过程中，t 总是会指向父节点的左子节点或右子节点
-            /// 所以这里实际上是将新节点挂在父节点的左子节点或右子节点上
-            t = new BinaryNode{x, nullptr, nullptr};
-        } else if (x < t->element) {
-            insert(x, t->left);
-        } else if (x > t->element) {
-            insert(x, t->right);
+        std::vector<BinaryNode **> path;
+        BinaryNode **p = findSlot(x, t, path);
+        /// *p 就是父节点的左指针或右指针 (或者 t 本身)，它现在存了 nullptr,
+        /// 把新节点赋给它，新节点就挂在了父节点上。新的叶子高度为 0，本身不需要 balance
+        if (*p == nullptr) {
+            *p = new BinaryNode{x, nullptr, nullptr};
+            (*p)->parent = path.empty() ? nullptr : *path.back();
         } else {
             /// 如果元素已存在，则不进行插入
             /// 这种情况不可遗漏，严格的规则中也可以抛出异常
         }
 
-        balance(t);
+        balancePath(path);
     }
 
     /**
-     * @brief 递归插入一个右值引用元素到树中
+     * @brief 插入一个右值引用元素到树中
      * 
      * @param x 要插入的元素
      * @param t 当前节点指针
      */
     void insert(Comparable &&x, BinaryNode * &t) {
         /// 一样的逻辑
-        if (t == nullptr) {
-            t = new BinaryNode{std::move(x), nullptr, nullptr};
-        } else if (x < t->element) {
-            insert(std::move(x), t->left);
-        } else if (x > t->element) {
-            insert(std::move(x), t->right);
-        } else {
-            // 如果元素已存在，则不进行插入
+        std::vector<BinaryNode **> path;
+        BinaryNode **p = findSlot(x, t, path);
+        if (*p == nullptr) {
+            *p = new BinaryNode{std::move(x), nullptr, nullptr};
+            (*p)->parent = path.empty() ? nullptr : *path.back();
         }
 
-        balance(t);
+        balancePath(path);
     }
 
     /**
      * @brief 查找以 t 为根的子树中的最小节点，返回这个节点，并从原子树中删除这个节点
      * 
+     * 一路向左记下经过的指针，摘下最小节点之后再从下往上 balance 它们。
+     * 
      * @param t 当前节点指针
      */
     BinaryNode *detachMin(BinaryNode *&t) {
         if (t == nullptr)
             return nullptr;
-        if (t->left != nullptr) {
-            BinaryNode *minNode =  detachMin(t->left);
-            balance(t); 
-            return minNode;
-        } else {
-            BinaryNode *minNode = t;
-            t = t->right;
-            return minNode;
+        std::vector<BinaryNode **> path;
+        BinaryNode **p = &t;
+        while ((*p)->left != nullptr) {
+            path.push_back(p);
+            p = &(*p)->left;
         }
+        BinaryNode *minNode = *p;
+        *p = minNode->right;
+        if (*p != nullptr) {
+            (*p)->parent = minNode->parent;
+        }
+        balancePath(path);
+        return minNode;
     }
 
     /**
-     * @brief 递归从树中移除指定的元素
+     * @brief 从树中移除指定的元素
      * 
      * @param x 要移除的元素
      * @param t 当前节点指针
      */
     void remove(const Comparable &x, BinaryNode * &t) {
         /// 这个逻辑其实是 find and remove, 从 t 开始
-        if (t == nullptr) {
-            return;  /// 元素不存在
-        }
-        if (x < t->element) {
-            remove(x, t->left);
-        } else if (x > t->element) {
-            remove(x, t->right);
-        } 
-        /// 进入以下这两个分支，都是说明找到了要删除的元素
-        else if (t->left != nullptr && t->right != nullptr) {  /// 有两个子节点
-            BinaryNode *oldNode = t;
-            // 找到替换节点，并将当前节点的信息传递给该节点
-            t = detachMin(t->right); 
-            t->left = oldNode->left; 
-            if(oldNode->right == t)    // 如果替换的节点正好是右子节点，则应为右子节点的右子节点(包含了nullptr的情况)
-                t->right = oldNode->right->right; 
-            else
-                t->right = oldNode->right;
-            delete oldNode;
-        } else {
-            /// 有一个或没有子节点的情形是简单的
-            BinaryNode *oldNode = t;
-            t = (t->left != nullptr) ? t->left : t->right;
+        std::vector<BinaryNode **> path;
+        BinaryNode **p = findSlot(x, t, path);
+        BinaryNode *oldNode = *p;
+        if (oldNode != nullptr) {
+            if (oldNode->left != nullptr && oldNode->right != nullptr) {  /// 有两个子节点
+                /// 用右子树的最小节点顶替被删的节点。摘下它时已经修改并 balance 过 oldNode->right，
+                /// 直接接过来即可
+                BinaryNode *minNode = detachMin(oldNode->right);
+                minNode->left = oldNode->left;
+                minNode->right = oldNode->right;
+                minNode->left->parent = minNode;
+                if (minNode->right != nullptr) {
+                    minNode->right->parent = minNode;
+                }
+                *p = minNode;
+            } else {
+                /// 有一个或没有子节点的情形是简单的
+                *p = (oldNode->left != nullptr) ? oldNode->left : oldNode->right;
+            }
+            if (*p != nullptr) {
+                (*p)->parent = oldNode->parent;
+            }
             delete oldNode;
+            balance(*p);
         }
+        /// 和递归版本一样，元素不存在时沿途的节点也 balance 一遍
 
-        balance(t); 
+        balancePath(path);
     }
 
     static const int ALLOWED_IMBALANCE = 1; // 静态(全局)变量
@@ -484,7 +1056,7 @@ protected:
             else
                 doubleWithRightChild( t );
         }  
-        t->height = max( height( t->left ), height( t->right ) ) + 1;
+        update( t );
     }
     
 
@@ -496,6 +1068,57 @@ protected:
         return t == nullptr ? -1 : t->height;
     }
 
+    /**
+     * @brief 得到以 t 为根的子树的聚合值，空子树为幺元
+     */
+    static AugmentValue subtreeValue( BinaryNode *t )
+    {
+        return t == nullptr ? AugmentPolicy::identity() : t->value;
+    }
+
+    /**
+     * @brief 得到以 t 为根的子树的大小，只有增强策略能计数时可用
+     */
+    static int subtreeSize( BinaryNode *t )
+    {
+        return AugmentPolicy::count( subtreeValue( t ) );
+    }
+
+    /**
+     * @brief 由左右子树重新计算 t 的高度 (以及聚合值)
+     * 
+     * 所有改变子树形状的地方 (balance 和两种单旋转) 最后都调用它，所以聚合值
+     * 和高度一样，不需要在插入和删除中另外维护。每次只用两个子节点中存好的值，O(1)。
+     */
+    void update( BinaryNode *t )
+    {
+        t->height = max( height( t->left ), height( t->right ) ) + 1;
+        if constexpr ( AugmentPolicy::enabled )
+            t->value = AugmentPolicy::combine( AugmentPolicy::combine( subtreeValue( t->left ),
+                                                                       AugmentPolicy::of( t->element ) ),
+                                               subtreeValue( t->right ) );
+    }
+
+    /**
+     * @brief 树中小于 x (inclusive 时为不大于 x) 的元素个数
+     * 
+     * 向右走时，左子树和当前节点都比 x 小，一起计入。
+     */
+    int countBelow( const Comparable &x, bool inclusive ) const
+    {
+        int n = 0;
+        BinaryNode *t = root;
+        while ( t != nullptr ) {
+            if ( t->element < x || ( inclusive && !( x < t->element ) ) ) {
+                n += subtreeSize( t->left ) + 1;
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return n;
+    }
+
     /**
      * @brief 得到两者中较大的一个
      */
@@ -507,31 +1130,39 @@ protected:
     /**
      * @brief Rotate binary tree node with left child.
      * For AVL trees, this is a single rotation for case 1.
-     * Update heights, then set new root.
+     * Update heights (and aggregates), then set new root.
      */
     void rotateWithLeftChild( BinaryNode * & k2 )
     {
         BinaryNode *k1 = k2->left;
         k2->left = k1->right;
+        if (k2->left != nullptr)
+            k2->left->parent = k2;
         k1->right = k2;
-        k2->height = max( height( k2->left ), height( k2->right ) ) + 1;
-        k1->height = max( height( k1->left ), k2->height ) + 1;
+        k1->parent = k2->parent;
+        k2->parent = k1;
+        update( k2 );   // k2 现在是 k1 的子节点，要先算
+        update( k1 );
         k2 = k1;    // 实现parent指向的转换
     }
 
     /**
      * @brief Rotate binary tree node with right child.
      * For AVL trees, this is a single rotation for case 4.
-     * Update heights, then set new root.
+     * Update heights (and aggregates), then set new root.
      * k2 <-> k1, left <-> right
      */
     void rotateWithRightChild( BinaryNode * & k1 )
     {
         BinaryNode *k2 = k1->right;
         k1->right = k2->left;
+        if (k1->right != nullptr)
+            k1->right->parent = k1;
         k2->left = k1;
-        k1->height = max( height( k1->left ), height( k1->right ) ) + 1;
-        k2->height = max( height( k2->right ), k1->height ) + 1;
+        k2->parent = k1->parent;
+        k1->parent = k2;
+        update( k1 );
+        update( k2 );
         k1 = k2;
     }
 
@@ -539,7 +1170,7 @@ protected:
      * @brief Double rotate binary tree node: first left child.
      * with its right child; then node k3 with new left child.
      * For AVL trees, this is a double rotation for case 2.
-     * Update heights, then set new root.
+     * Update heights (and aggregates), then set new root.
      */
     void doubleWithLeftChild( BinaryNode * & k3 )
     {
@@ -551,7 +1182,7 @@ protected:
      * @brief Double rotate binary tree node: first right child.
      * with its left child; then node k1 with new right child.
      * For AVL trees, this is a double rotation for case 3.
-     * Update heights, then set new root.
+     * Update heights (and aggregates), then set new root.
      */
     void doubleWithRightChild( BinaryNode * & k1 )
     {
@@ -560,16 +1191,45 @@ protected:
     }
 
     /**
-     * @brief 递归克隆树的结构
+     * @brief 克隆树的结构，连同每个节点的高度和聚合值
+     * 
+     * 不用递归，也不用原树的父指针：栈里放的是 "原树中的一个节点，它的拷贝应该挂到的那个指针，
+     * 以及那个指针所在的新节点"。每拷贝一个节点，就把它的两个子节点连同新节点的左右指针压栈。
+     * 中途分配失败时，已经拷贝好的部分都挂在 copy 上，整体释放后再把异常抛出去。
      * 
      * @param t 当前节点指针
      * @return 新的节点指针
      */
     BinaryNode *clone(BinaryNode *t) const {
-        if (t == nullptr) {
-            return nullptr;
+        BinaryNode *copy = nullptr;
+        std::vector<std::tuple<const BinaryNode *, BinaryNode **, BinaryNode *>> stack;
+        stack.push_back({t, &copy, nullptr});
+        try {
+            while (!stack.empty()) {
+                auto [from, to, parent] = stack.back();
+                stack.pop_back();
+                if (from == nullptr) {
+                    continue;
+                }
+                *to = new BinaryNode{from->element, nullptr, nullptr, from->height};
+                (*to)->parent = parent;
+                if constexpr (AugmentPolicy::enabled)
+                    (*to)->value = from->value;
+                stack.push_back({from->right, &(*to)->right, *to});
+                stack.push_back({from->left, &(*to)->left, *to});
+            }
+        } catch (...) {
+            makeEmpty(copy);
+            throw;
         }
-        return new BinaryNode{t->element, clone(t->left), clone(t->right)};
+        return copy;
     }
 };
 
+/// 顺序统计树：维护子树大小的 AVL 树，可以按名次查找
+template <typename Comparable>
+using OrderStatisticsTree = BinarySearchTree<Comparable, OrderStatistics>;
+
+#else
+// DO NOTHING.
+#endif
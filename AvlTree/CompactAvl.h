@@ -0,0 +1,594 @@
+#ifndef __COMPACT_AVL_MARK__
+#define __COMPACT_AVL_MARK__
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BST.h"    // 异常类
+
+/**
+ * @file CompactAvl.h
+ * @brief 紧凑布局的 AVL 树
+ *
+ * BinarySearchTree 的每个节点单独 new 出来，带三个 64 位指针和一个 int 高度，
+ * BinarySearchTree<int> 的节点有 40 字节，而且散落在堆上，查找时每往下走一层都可能是一次缓存缺失。
+ * 这里所有节点放在同一个数组 (arena) 里，用 32 位下标代替指针，不存高度和父指针，
+ * 只存 -1、0、+1 三种平衡因子，塞进右子节点下标的最高 2 位，int 的节点只有 12 字节。
+ * rebuild 时按层序 (BFS) 重新排列节点：树的上面几层挨在数组的最前面，总是在缓存里。
+ */
+
+/// 节点个数超过 30 位下标能表示的范围
+class CapacityExceededException { };
+
+/**
+ * @brief 节点放在数组里、用下标相连的 AVL 树
+ *
+ * 接口与 BinarySearchTree 相同的部分行为也相同 (不存重复元素，空树时 findMin 抛出 UnderflowException)。
+ * 没有父指针，所以不提供迭代器，按顺序访问用 for_each / for_each_in_range。
+ * 删除的节点进入空闲链表，下次插入时复用，其中的元素 (已被移走或覆盖) 直到复用或 makeEmpty 时才析构。
+ * 数组扩容时节点会整体搬家，但下标不变，所以树的结构不受影响。
+ *
+ * @tparam Comparable 元素类型
+ */
+template <typename Comparable>
+class CompactAvlTree
+{
+public:
+    CompactAvlTree() = default;
+
+    /// 节点都在 vector 里，拷贝和析构直接用 vector 的，不需要逐个节点处理
+    CompactAvlTree(const CompactAvlTree &rhs) = default;
+    CompactAvlTree &operator=(const CompactAvlTree &rhs) = default;
+
+    /**
+     * @brief 移动构造函数。接管 rhs 的节点数组，rhs 之后为空树
+     *
+     * 不能直接用缺省的：vector 被移走后，rhs 的 root 和 theSize 还是原来的值，会指向已经不存在的节点。
+     *
+     * @param rhs 要移动的树
+     */
+    CompactAvlTree(CompactAvlTree &&rhs) noexcept
+        : nodes{ std::move(rhs.nodes) }, root{ rhs.root }, freeList{ rhs.freeList }, theSize{ rhs.theSize } {
+        rhs.reset();
+    }
+
+    /**
+     * @brief 移动赋值运算符。原来的节点全部释放，rhs 之后为空树
+     *
+     * @param rhs 要移动的树
+     * @return 当前树的引用
+     */
+    CompactAvlTree &operator=(CompactAvlTree &&rhs) noexcept {
+        if (this != &rhs) {
+            nodes = std::move(rhs.nodes);
+            root = rhs.root;
+            freeList = rhs.freeList;
+            theSize = rhs.theSize;
+            rhs.reset();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 查找并返回树中的最小元素，空树时抛出 UnderflowException
+     */
+    const Comparable &findMin() const {
+        if (isEmpty())
+            throw UnderflowException{ };
+        Index t = root;
+        while (node(t).left != NIL)
+            t = node(t).left;
+        return node(t).element;
+    }
+
+    /**
+     * @brief 查找并返回树中的最大元素，空树时抛出 UnderflowException
+     */
+    const Comparable &findMax() const {
+        if (isEmpty())
+            throw UnderflowException{ };
+        Index t = root;
+        while (node(t).right != NIL)
+            t = node(t).right;
+        return node(t).element;
+    }
+
+    /**
+     * @brief 检查树中是否包含指定的元素
+     *
+     * @param x 要查找的元素
+     * @return 如果树中包含该元素，则返回 true；否则返回 false
+     */
+    bool contains(const Comparable &x) const {
+        Index t = root;
+        while (t != NIL) {
+            const Node &n = node(t);
+            if (x < n.element) {
+                t = n.left;
+            } else if (n.element < x) {
+                t = n.right;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isEmpty() const {
+        return root == NIL;
+    }
+
+    /**
+     * @brief 元素个数，O(1)
+     */
+    int size() const {
+        return theSize;
+    }
+
+    /**
+     * @brief 预留 n 个节点的空间，之后的插入不会再让数组扩容
+     */
+    void reserve(int n) {
+        nodes.reserve(n);
+    }
+
+    /**
+     * @brief 清空树，释放所有节点
+     */
+    void makeEmpty() {
+        reset();
+    }
+
+    /**
+     * @brief 插入一个元素，已存在时什么也不做
+     */
+    void insert(const Comparable &x) {
+        insertImpl(x);
+    }
+
+    void insert(Comparable &&x) {
+        insertImpl(std::move(x));
+    }
+
+    /**
+     * @brief 从树中移除指定的元素，不存在时什么也不做
+     *
+     * 从上往下找的时候记下路径 (AVL 树高不超过 1.44 log n，固定长度的数组就够)，
+     * 删掉节点后沿路径往上修改平衡因子，直到某一层的子树高度不再变化。
+     *
+     * @param x 要移除的元素
+     */
+    void remove(const Comparable &x) {
+        Step path[MAX_HEIGHT];
+        int depth = 0;
+        Index t = root;
+        while (t != NIL) {
+            if (x < node(t).element) {
+                path[depth++] = {t, false};
+                t = node(t).left;
+            } else if (node(t).element < x) {
+                path[depth++] = {t, true};
+                t = node(t).right;
+            } else {
+                break;
+            }
+        }
+        if (t == NIL)
+            return;
+        if (node(t).left != NIL && node(t).right != NIL) {
+            /// 有两个子节点：把右子树的最小元素移过来，改为删除那个最多只有一个子节点的节点
+            path[depth++] = {t, true};
+            Index s = node(t).right;
+            while (node(s).left != NIL) {
+                path[depth++] = {s, false};
+                s = node(s).left;
+            }
+            node(t).element = std::move(node(s).element);
+            t = s;
+        }
+        relink(path, depth, node(t).left != NIL ? node(t).left : node(t).right);
+        release(t);
+
+        /// path[depth] 的 right 那一侧矮了 1
+        while (depth > 0) {
+            Step s = path[--depth];
+            int b = node(s.n).balance() + (s.right ? -1 : 1);
+            if (b == 1 || b == -1) {
+                node(s.n).setBalance(b);    // 原来两边一样高，现在整棵子树的高度不变
+                return;
+            }
+            if (b == 0) {
+                node(s.n).setBalance(0);    // 高的一侧变矮了，整棵子树也矮了 1
+                continue;
+            }
+            bool shrunk;
+            relink(path, depth, rebalance(s.n, b / 2, shrunk));
+            if (!shrunk)
+                return;
+        }
+    }
+
+    /**
+     * @brief 把树整理成高度最小的树，并按层序重新排列节点
+     *
+     * 先按中序记下节点的下标，再像 from_sorted 一样按层序建一棵新树，把元素逐个移过去：
+     * 下标 1 是根，2、3 是第二层，依此类推，查找路径的前几层落在数组开头同一段连续的内存中。
+     * 空闲链表中的节点也一并丢掉。O(n) 时间，额外用一个 n 个下标的数组。
+     * 所有内存都在移动第一个元素之前分配好，分配失败时原来的树保持不变
+     * (前提是元素的移动构造不抛出异常)。
+     */
+    void rebuild() {
+        std::vector<Index> order;
+        order.reserve(theSize);
+        inorder(*this, [this, &order](const Node &n) { order.push_back(static_cast<Index>(&n - nodes.data() + 1)); });
+        *this = layout(order.size(), [this, &order](int k) -> Comparable && { return std::move(node(order[k]).element); });
+    }
+
+    /**
+     * @brief 由有序序列直接建一棵按层序排列的、高度最小的树，O(n)
+     *
+     * @tparam Iterator 输入迭代器，元素必须按 < 非降序排列，否则抛出 IllegalArgumentException，
+     * 相等的相邻元素只保留第一个
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return 建好的树
+     */
+    template <typename Iterator>
+    static CompactAvlTree from_sorted(Iterator first, Iterator last) {
+        std::vector<Comparable> sorted;
+        for (; first != last; ++first) {
+            if (!sorted.empty() && !(sorted.back() < *first)) {
+                if (*first < sorted.back())
+                    throw IllegalArgumentException{ };
+                continue;   // 重复的元素
+            }
+            sorted.push_back(*first);
+        }
+        return layout(sorted.size(), [&sorted](int k) -> Comparable && { return std::move(sorted[k]); });
+    }
+
+    /**
+     * @brief 按从小到大的顺序对每个元素调用 f
+     */
+    template <typename Function>
+    void for_each(Function f) const {
+        inorder(*this, [&f](const Node &n) { f(n.element); });
+    }
+
+    /**
+     * @brief 按从小到大的顺序对闭区间 [lo, hi] 中的每个元素调用 f，区间外的子树不会被访问
+     */
+    template <typename Function>
+    void for_each_in_range(const Comparable &lo, const Comparable &hi, Function f) const {
+        Index stack[MAX_HEIGHT];
+        int top = 0;
+        Index t = root;
+        for (;;) {
+            if (t != NIL) {
+                if (node(t).element < lo) {
+                    t = node(t).right;  // 左子树和 t 都在区间左边
+                } else {
+                    stack[top++] = t;
+                    t = node(t).left;
+                }
+            } else if (top > 0) {
+                t = stack[--top];
+                if (hi < node(t).element)
+                    return;
+                f(node(t).element);
+                t = node(t).right;
+            } else {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief 打印树的结构，格式与 BinarySearchTree::printTree 相同
+     */
+    void printTree(std::ostream &out = std::cout) const {
+        if (isEmpty()) {
+            out << "Empty tree" << std::endl;
+        } else {
+            out << "root" << std::endl;
+            printTree(root, out, "", 1, true);
+        }
+    }
+
+protected:
+    using Index = std::uint32_t;                        ///< 节点下标，从 1 开始
+    static constexpr Index NIL = 0;                     ///< 空下标，相当于 nullptr
+    static constexpr Index MAX_NODES = (Index{ 1 } << 30) - 1; ///< 右子节点下标只有 30 位
+    static constexpr int MAX_HEIGHT = 64;               ///< 2^30 个节点的 AVL 树高不超过 44
+
+    /**
+     * @brief 树节点，右子节点下标和平衡因子共用一个 32 位整数
+     */
+    struct Node
+    {
+        Comparable element;     ///< 节点存储的元素
+        Index left;             ///< 左子节点下标，节点在空闲链表中时是下一个空闲节点
+        Index right : 30;       ///< 右子节点下标
+        Index bal : 2;          ///< 平衡因子 (右子树高度 - 左子树高度) 加 1，取 0、1、2
+
+        int balance() const {
+            return static_cast<int>(bal) - 1;
+        }
+
+        void setBalance(int b) {
+            bal = static_cast<Index>(b + 1);
+        }
+    };
+
+    /// 查找路径上的一步：经过的节点，以及从它往哪边走
+    struct Step
+    {
+        Index n;
+        bool right;
+    };
+
+    std::vector<Node> nodes;    ///< 所有节点，下标为 i 的节点是 nodes[i - 1]
+    Index root = NIL;           ///< 根节点下标
+    Index freeList = NIL;       ///< 空闲链表，通过 left 串起来
+    int theSize = 0;            ///< 元素个数
+
+    Node &node(Index i) {
+        return nodes[i - 1];
+    }
+
+    const Node &node(Index i) const {
+        return nodes[i - 1];
+    }
+
+    /**
+     * @brief 取一个节点存放 x：优先复用空闲链表中的节点，否则接在数组末尾
+     *
+     * @return 新节点的下标，它是一片平衡的叶子
+     */
+    template <typename X>
+    Index allocate(X &&x) {
+        Index i;
+        if (freeList != NIL) {
+            i = freeList;
+            freeList = node(i).left;
+            node(i).element = std::forward<X>(x);
+            node(i).left = NIL;
+            node(i).right = NIL;
+            node(i).setBalance(0);
+        } else {
+            if (nodes.size() >= MAX_NODES)
+                throw CapacityExceededException{ };
+            nodes.push_back(Node{ Comparable(std::forward<X>(x)), NIL, NIL, 1 });
+            i = static_cast<Index>(nodes.size());
+        }
+        ++theSize;
+        return i;
+    }
+
+    /**
+     * @brief 回到空树，释放所有节点
+     */
+    void reset() noexcept {
+        nodes.clear();
+        root = NIL;
+        freeList = NIL;
+        theSize = 0;
+    }
+
+    /**
+     * @brief 把节点 i 放回空闲链表
+     */
+    void release(Index i) {
+        node(i).left = freeList;
+        freeList = i;
+        --theSize;
+    }
+
+    /**
+     * @brief 把 path[depth - 1] 指向下一层的那个链接改成 child；depth 为 0 时改的是 root
+     */
+    void relink(const Step *path, int depth, Index child) {
+        if (depth == 0) {
+            root = child;
+        } else if (path[depth - 1].right) {
+            node(path[depth - 1].n).right = child;
+        } else {
+            node(path[depth - 1].n).left = child;
+        }
+    }
+
+    /**
+     * @brief 与 BinarySearchTree::insert 一样先找位置，再沿路径往上修改平衡因子：
+     * 某一层变成 0 说明子树高度没变，可以停下；变成 ±2 时旋转一次，旋转后子树恢复原来的高度，也可以停下
+     */
+    template <typename X>
+    void insertImpl(X &&x) {
+        Step path[MAX_HEIGHT];
+        int depth = 0;
+        Index t = root;
+        while (t != NIL) {
+            if (x < node(t).element) {
+                path[depth++] = {t, false};
+                t = node(t).left;
+            } else if (node(t).element < x) {
+                path[depth++] = {t, true};
+                t = node(t).right;
+            } else {
+                return;     // 元素已存在
+            }
+        }
+        relink(path, depth, allocate(std::forward<X>(x)));
+
+        /// path[depth] 的 right 那一侧高了 1
+        while (depth > 0) {
+            Step s = path[--depth];
+            int b = node(s.n).balance() + (s.right ? 1 : -1);
+            if (b == 0) {
+                node(s.n).setBalance(0);
+                return;
+            }
+            if (b == 1 || b == -1) {
+                node(s.n).setBalance(b);
+                continue;
+            }
+            bool shrunk;
+            relink(path, depth, rebalance(s.n, b / 2, shrunk));
+            return;
+        }
+    }
+
+    Index rotateWithLeftChild(Index k2) {
+        Index k1 = node(k2).left;
+        node(k2).left = node(k1).right;
+        node(k1).right = k2;
+        return k1;
+    }
+
+    Index rotateWithRightChild(Index k1) {
+        Index k2 = node(k1).right;
+        node(k1).right = node(k2).left;
+        node(k2).left = k1;
+        return k2;
+    }
+
+    /**
+     * @brief t 的一侧比另一侧高 2 (平衡因子存不下，由 dir 给出) 时旋转
+     *
+     * 与 BinarySearchTree::balance 的四种情形相同，只是不重新计算高度，
+     * 而是按旋转前高的那个子节点 (以及双旋转时的孙节点) 的平衡因子直接写出旋转后的平衡因子。
+     *
+     * @param t 失衡的节点
+     * @param dir +1 表示右边高，-1 表示左边高
+     * @param shrunk 输出，旋转后的子树是否比失衡时矮了 1。只有删除时才可能为 false
+     * @return 旋转后的子树根
+     */
+    Index rebalance(Index t, int dir, bool &shrunk) {
+        bool right = dir > 0;
+        Index c = right ? node(t).right : node(t).left;
+        int cb = node(c).balance();
+        if (cb == -dir) {
+            /// 双旋转：孙节点 g 成为根，它的两棵子树分给 t 和 c
+            Index g = right ? node(c).left : node(c).right;
+            int gb = node(g).balance();
+            if (right) {
+                node(t).right = rotateWithLeftChild(c);
+                rotateWithRightChild(t);
+            } else {
+                node(t).left = rotateWithRightChild(c);
+                rotateWithLeftChild(t);
+            }
+            node(t).setBalance(gb == dir ? -dir : 0);
+            node(c).setBalance(gb == -dir ? dir : 0);
+            node(g).setBalance(0);
+            shrunk = true;
+            return g;
+        }
+        if (right) {
+            rotateWithRightChild(t);
+        } else {
+            rotateWithLeftChild(t);
+        }
+        if (cb == dir) {
+            node(t).setBalance(0);
+            node(c).setBalance(0);
+            shrunk = true;
+        } else {
+            /// 只在删除时出现：c 两边一样高，旋转后整棵子树高度不变
+            node(t).setBalance(dir);
+            node(c).setBalance(-dir);
+            shrunk = false;
+        }
+        return c;
+    }
+
+    /**
+     * @brief 中序遍历，栈的深度不超过树高。const 和非 const 的树共用，f 拿到的节点随之带不带 const
+     */
+    template <typename Tree, typename Function>
+    static void inorder(Tree &tree, Function f) {
+        Index stack[MAX_HEIGHT];
+        int top = 0;
+        Index t = tree.root;
+        while (t != NIL || top > 0) {
+            if (t != NIL) {
+                stack[top++] = t;
+                t = tree.node(t).left;
+            } else {
+                t = stack[--top];
+                f(tree.node(t));
+                t = tree.node(t).right;
+            }
+        }
+    }
+
+    /**
+     * @brief 由 m 个元素按中间元素为根建成的树的高度，m = 0 时为 -1
+     */
+    static int rangeHeight(int m) {
+        int h = -1;
+        for (; m > 0; m >>= 1)
+            ++h;
+        return h;
+    }
+
+    /**
+     * @brief 由严格递增的 count 个元素建树，节点按层序编号
+     *
+     * 每个子树对应元素序列中的一段，中间的元素做根。用一个队列按层序处理这些段，
+     * 段进队的顺序就是节点的编号，所以处理一个段时它的两个子段的编号已经知道了。
+     * 左段不短于右段，平衡因子是 0 或 -1，树高为 floor(log2 n)。
+     * 节点数组和队列都先分配好，之后才通过 take 取元素，所以抛出异常时元素还没有被移走。
+     *
+     * @param count 元素个数
+     * @param take take(k) 返回第 k 小元素的右值引用，每个 k 只调用一次
+     */
+    template <typename Take>
+    static CompactAvlTree layout(std::size_t count, Take take) {
+        if (count > MAX_NODES)
+            throw CapacityExceededException{ };
+        int n = static_cast<int>(count);
+        CompactAvlTree tree;
+        tree.nodes.reserve(n);
+        std::vector<std::pair<int, int>> queue;     // 第 k 个段是下标为 k + 1 的节点
+        queue.reserve(n);
+        if (n > 0)
+            queue.push_back({0, n});
+        for (std::size_t k = 0; k < queue.size(); ++k) {
+            auto [lo, hi] = queue[k];
+            int mid = lo + (hi - lo) / 2;
+            Index l = NIL, r = NIL;
+            if (lo < mid) {
+                queue.push_back({lo, mid});
+                l = static_cast<Index>(queue.size());
+            }
+            if (mid + 1 < hi) {
+                queue.push_back({mid + 1, hi});
+                r = static_cast<Index>(queue.size());
+            }
+            int b = rangeHeight(hi - mid - 1) - rangeHeight(mid - lo);
+            tree.nodes.push_back(Node{ take(mid), l, r, static_cast<Index>(b + 1) });
+        }
+        tree.root = n > 0 ? 1 : NIL;
+        tree.theSize = n;
+        return tree;
+    }
+
+    /**
+     * @brief 与 BinarySearchTree::printTree 相同的递归打印，深度就是树高
+     */
+    void printTree(Index t, std::ostream &out, std::string prePrint, int numofChild, bool noBrother) const {
+        if (t != NIL) {
+            printTree(node(t).left, out, prePrint + (numofChild < 1 ? "    " : "│   "), 0, node(t).right == NIL);
+            out << prePrint << (numofChild < 1 ? "┌───" : "└───") << node(t).element << std::endl;
+            printTree(node(t).right, out, prePrint + (numofChild < 1 ? "│   " : "    "), 1, node(t).left == NIL);
+        } else if (!noBrother) {
+            out << prePrint << (numofChild < 1 ? "┌───" : "└───") << "#" << std::endl;
+        }
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,163 @@
+#ifndef __INTERVAL_TREE_MARK__
+#define __INTERVAL_TREE_MARK__
+
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "BST.h"
+
+/**
+ * @file IntervalTree.h
+ * @brief 区间树，增强 AVL 树的一个例子
+ *
+ * 区间按左端点 (左端点相同时按右端点) 排序存进 AVL 树，每个节点用 MaxEnd 策略维护子树中
+ * 最大的右端点。查找与 [lo, hi] 相交的区间时，子树的最大右端点小于 lo 就整个跳过，
+ * 遇到左端点大于 hi 的节点就可以停下，k 个结果只需要访问 O((k + 1) log n) 个节点。
+ */
+
+/**
+ * @brief 闭区间 [lo, hi]
+ */
+template <typename T>
+struct Interval
+{
+    using value_type = T;
+
+    T lo;   ///< 左端点
+    T hi;   ///< 右端点
+
+    /// 是否与闭区间 [a, b] 相交
+    bool overlaps(const T &a, const T &b) const {
+        return !(b < lo) && !(hi < a);
+    }
+
+    bool operator<(const Interval &rhs) const {
+        return lo < rhs.lo || (!(rhs.lo < lo) && hi < rhs.hi);
+    }
+
+    bool operator>(const Interval &rhs) const {
+        return rhs < *this;
+    }
+
+    bool operator==(const Interval &rhs) const {
+        return !(*this < rhs) && !(rhs < *this);
+    }
+
+    friend std::ostream &operator<<(std::ostream &out, const Interval &iv) {
+        return out << "[" << iv.lo << "," << iv.hi << "]";
+    }
+};
+
+/**
+ * @brief 子树中最大的右端点
+ *
+ * @tparam I 区间类型，例如 Interval<int>
+ */
+template <typename I>
+struct MaxEnd
+{
+    using value_type = typename I::value_type;
+    static constexpr bool enabled = true;
+    static value_type identity() { return std::numeric_limits<value_type>::lowest(); }
+    static value_type of(const I &iv) { return iv.hi; }
+    static value_type combine(const value_type &a, const value_type &b) { return a < b ? b : a; }
+};
+
+/**
+ * @brief 区间树。插入、删除、拷贝、rebuild、迭代器都直接用 BinarySearchTree 的，
+ * 旋转时 MaxEnd 和高度一起维护
+ *
+ * @tparam T 端点类型
+ */
+template <typename T>
+class IntervalTree : public BinarySearchTree<Interval<T>, MaxEnd>
+{
+    using Base = BinarySearchTree<Interval<T>, MaxEnd>;
+    using typename Base::BinaryNode;
+    using Base::root;
+
+public:
+    using Base::insert;
+
+    /**
+     * @brief 插入区间 [lo, hi]，hi < lo 时抛出 IllegalArgumentException
+     */
+    void insert(const T &lo, const T &hi) {
+        if (hi < lo) {
+            throw IllegalArgumentException{ };
+        }
+        Base::insert(Interval<T>{ lo, hi });
+    }
+
+    /**
+     * @brief 任意一个与 [lo, hi] 相交的区间，O(log n)
+     *
+     * 左子树的最大右端点不小于 lo 时，如果左子树里没有相交的区间，右子树里也不会有
+     * (左子树里那个右端点最大的区间左端点已经大于 hi，右子树的左端点只会更大)，
+     * 所以每一层只需要往一边走。
+     *
+     * @return 指向树中该区间的指针，没有时为 nullptr
+     */
+    const Interval<T> *any_overlapping(const T &lo, const T &hi) const {
+        const BinaryNode *t = root;
+        while (t != nullptr && !t->element.overlaps(lo, hi)) {
+            if (t->left != nullptr && !(t->left->value < lo)) {
+                t = t->left;
+            } else {
+                t = t->right;
+            }
+        }
+        return t == nullptr ? nullptr : &t->element;
+    }
+
+    /**
+     * @brief 按从小到大的顺序对每个与 [lo, hi] 相交的区间调用 f
+     *
+     * 带剪枝的中序遍历，栈的深度不超过树高：最大右端点小于 lo 的子树不进去，
+     * 中序走到左端点大于 hi 的区间时，后面的区间左端点都更大，直接结束。
+     *
+     * @param f 以 const Interval<T> & 为参数的函数
+     */
+    template <typename Function>
+    void for_each_overlapping(const T &lo, const T &hi, Function f) const {
+        std::vector<const BinaryNode *> stack;
+        const BinaryNode *t = root;
+        for (;;) {
+            if (t != nullptr && !(t->value < lo)) {
+                stack.push_back(t);
+                t = t->left;
+            } else if (!stack.empty()) {
+                t = stack.back();
+                stack.pop_back();
+                if (hi < t->element.lo) {
+                    return;
+                }
+                if (!(t->element.hi < lo)) {
+                    f(t->element);
+                }
+                t = t->right;
+            } else {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief 包含点 x 的所有区间 (stabbing query)
+     */
+    template <typename Function>
+    void for_each_containing(const T &x, Function f) const {
+        for_each_overlapping(x, x, f);
+    }
+
+    /**
+     * @brief 所有区间中最大的右端点，O(1)。空树时为 T 的最小值
+     */
+    T max_end() const {
+        return this->aggregate();
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,340 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "IntervalTree.h"
+#include "CompactAvl.h"
+
+/**
+ * @brief 计时工具. 运行 f 一次，返回耗时 (毫秒).
+ *
+ * @param f 被计时的函数.
+ * @return double 耗时.
+ */
+template <typename F>
+double timeIt(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
+}
+
+/**
+ * @brief 防止编译器把结果优化掉.
+ *
+ */
+volatile long long sink;
+
+/**
+ * @brief n 个 [0, range) 中的随机数, 固定种子, 每次运行都一样.
+ */
+std::vector<int> randomKeys(int n, int range, unsigned seed)
+{
+    std::mt19937 rnd(seed);
+    std::vector<int> keys(n);
+    for (int &x : keys)
+        x = static_cast<int>(rnd() % static_cast<unsigned>(range));
+    return keys;
+}
+
+/**
+ * @brief 增强的代价: 随机插入 n 个键再删掉一半, 比较不同策略下的耗时.
+ *
+ * @tparam Tree 被测试的树类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename Tree>
+void overhead(int n, const char *name)
+{
+    std::vector<int> keys = randomKeys(n, 4 * n, 1);
+    Tree tree;
+    double ins = timeIt([&] {
+        for (int x : keys)
+            tree.insert(x);
+    });
+    double rem = timeIt([&] {
+        for (int i = 0; i < n; i += 2)
+            tree.remove(keys[i]);
+    });
+
+    std::cout << name << "\tn = " << n << "\tinsert: " << ins << " ms"
+              << "\tremove n/2: " << rem << " ms" << std::endl;
+}
+
+void benchOverhead()
+{
+    std::cout << "== maintenance cost: NoAugment vs OrderStatistics vs SubtreeSum ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        overhead<BinarySearchTree<int>>(n, "NoAugment      ");
+        overhead<BinarySearchTree<int, OrderStatistics>>(n, "OrderStatistics");
+        overhead<BinarySearchTree<long long, SubtreeSum>>(n, "SubtreeSum     ");
+    }
+}
+
+/**
+ * @brief 顺序统计: 查 q 次第 k 小的元素, 用 select 和从 begin() 数 k 步对比.
+ *
+ * @param n 元素个数.
+ * @param q 查询次数.
+ */
+void selects(int n, int q)
+{
+    OrderStatisticsTree<int> tree;
+    for (int x : randomKeys(n, 4 * n, 2))
+        tree.insert(x);
+    int size = tree.size();
+    std::vector<int> ks = randomKeys(q, 4 * n, 3);
+
+    double fast = timeIt([&] {
+        long long sum = 0;
+        for (int k : ks)
+            sum += tree.select(k % size) + tree.rank(k);
+        sink = sum;
+    });
+    double slow = timeIt([&] {
+        long long sum = 0;
+        for (int k : ks)
+        {
+            auto it = tree.begin();
+            for (int i = k % size; i > 0; --i)
+                ++it;
+            int below = 0;
+            for (auto j = tree.begin(); j != tree.end() && *j < k; ++j)
+                ++below;
+            sum += *it + below;
+        }
+        sink = sum;
+    });
+
+    std::cout << "n = " << n << "\tselect + rank x" << q << ": " << fast << " ms"
+              << "\titerator walk: " << slow << " ms" << std::endl;
+}
+
+void benchSelect()
+{
+    std::cout << "== order statistics: select/rank vs iterator walk ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        selects(n, 10);
+}
+
+/**
+ * @brief 区间和: q 个包含约 n/4 个元素的区间, 用 aggregate(lo, hi) 和 for_each_in_range 逐个累加对比.
+ *
+ * @param n 元素个数.
+ * @param q 查询次数.
+ */
+void rangeSums(int n, int q)
+{
+    BinarySearchTree<long long, SubtreeSum> tree;
+    for (int x : randomKeys(n, 4 * n, 4))
+        tree.insert(x);
+    std::vector<int> los = randomKeys(q, 3 * n, 5);
+
+    double fast = timeIt([&] {
+        long long sum = 0;
+        for (long long lo : los)
+            sum += tree.aggregate(lo, lo + n);
+        sink = sum;
+    });
+    double slow = timeIt([&] {
+        long long sum = 0;
+        for (long long lo : los)
+            tree.for_each_in_range(lo, lo + n, [&sum](long long x) { sum += x; });
+        sink = sum;
+    });
+
+    std::cout << "n = " << n << "\taggregate x" << q << ": " << fast << " ms"
+              << "\tfor_each_in_range: " << slow << " ms" << std::endl;
+}
+
+void benchAggregate()
+{
+    std::cout << "== range sum: aggregate vs for_each_in_range ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        rangeSums(n, 10);
+}
+
+/**
+ * @brief 区间树: n 个短区间, q 次查询与一个短区间相交的区间, 和扫描整个数组对比.
+ *
+ * @param n 区间个数.
+ * @param q 查询次数.
+ */
+void overlaps(int n, int q)
+{
+    std::vector<int> starts = randomKeys(n, 4 * n, 6);
+    std::vector<int> lens = randomKeys(n, 100, 7);
+    IntervalTree<int> tree;
+    std::vector<Interval<int>> all;
+    for (int i = 0; i < n; ++i)
+    {
+        int hi = starts[i] + lens[i];
+        tree.insert(starts[i], hi);
+        all.push_back({starts[i], hi});
+    }
+    std::vector<int> points = randomKeys(q, 4 * n, 8);
+
+    double fast = timeIt([&] {
+        long long hits = 0;
+        for (int lo : points)
+            tree.for_each_overlapping(lo, lo + 10, [&hits](const Interval<int> &) { ++hits; });
+        sink = hits;
+    });
+    double slow = timeIt([&] {
+        long long hits = 0;
+        for (int lo : points)
+            for (const auto &iv : all)
+                hits += iv.overlaps(lo, lo + 10);
+        sink = hits;
+    });
+
+    std::cout << "n = " << n << "\tIntervalTree x" << q << ": " << fast << " ms"
+              << "\tlinear scan: " << slow << " ms" << std::endl;
+}
+
+void benchInterval()
+{
+    std::cout << "== overlap queries: IntervalTree vs linear scan ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        overlaps(n, 100);
+}
+
+/// 读出两种树的节点大小
+struct PointerNodeSize : BinarySearchTree<int>
+{
+    static constexpr std::size_t value = sizeof(BinaryNode);
+};
+
+struct CompactNodeSize : CompactAvlTree<int>
+{
+    static constexpr std::size_t value = sizeof(Node);
+};
+
+/**
+ * @brief 在树中查找 lookups 次, 一半的键在树中 (偶数), 一半不在 (奇数).
+ *
+ * @return double 耗时.
+ */
+template <typename Tree>
+double lookups(const Tree &tree, const std::vector<int> &queries)
+{
+    return timeIt([&] {
+        long long hits = 0;
+        for (int x : queries)
+            hits += tree.contains(x);
+        sink = hits;
+    });
+}
+
+/**
+ * @brief 紧凑布局: n 个键, 比较指针树和下标树的建树和查找.
+ * 指针树用 from_sorted 建, 节点按中序依次分配, 这已经是它最好的内存布局;
+ * 下标树先按随机顺序逐个插入, 再 rebuild 成层序; n 太大时逐个插入太慢, 直接用 from_sorted 建成层序.
+ *
+ * @param n 元素个数.
+ * @param q 查找次数.
+ */
+void compact(int n, int q)
+{
+    std::vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+        keys[i] = 2 * i;
+    std::vector<int> queries = randomKeys(q, 2 * n, 9);
+
+    BinarySearchTree<int> pointers;
+    double ptrBuild = timeIt([&] { pointers = BinarySearchTree<int>::from_sorted(keys.begin(), keys.end()); });
+    double ptrFind = lookups(pointers, queries);
+    pointers.makeEmpty();
+
+    std::cout << "n = " << n << "\tcontains x" << q << std::endl
+              << "  BinarySearchTree (from_sorted: " << ptrBuild << " ms)\t" << ptrFind << " ms" << std::endl;
+
+    CompactAvlTree<int> indices;
+    if (n <= 1000000)
+    {
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(10));
+        double cmpInsert = timeIt([&] {
+            for (int x : keys)
+                indices.insert(x);
+        });
+        double cmpFind = lookups(indices, queries);
+        double cmpRebuild = timeIt([&] { indices.rebuild(); });
+        std::cout << "  CompactAvlTree   (random inserts: " << cmpInsert << " ms)\t" << cmpFind << " ms" << std::endl
+                  << "  CompactAvlTree   (rebuild to BFS: " << cmpRebuild << " ms)\t";
+    }
+    else
+    {
+        double cmpBuild = timeIt([&] { indices = CompactAvlTree<int>::from_sorted(keys.begin(), keys.end()); });
+        std::cout << "  CompactAvlTree   (from_sorted, BFS: " << cmpBuild << " ms)\t";
+    }
+    std::cout << lookups(indices, queries) << " ms" << std::endl;
+}
+
+/**
+ * @brief 随机插入 n 个键再删掉一半, 指针树与下标树对比.
+ */
+void compactUpdates(int n)
+{
+    std::vector<int> keys = randomKeys(n, 4 * n, 11);
+    BinarySearchTree<int> pointers;
+    CompactAvlTree<int> indices;
+    double ptrInsert = timeIt([&] {
+        for (int x : keys)
+            pointers.insert(x);
+    });
+    double ptrRemove = timeIt([&] {
+        for (int i = 0; i < n; i += 2)
+            pointers.remove(keys[i]);
+    });
+    double cmpInsert = timeIt([&] {
+        for (int x : keys)
+            indices.insert(x);
+    });
+    double cmpRemove = timeIt([&] {
+        for (int i = 0; i < n; i += 2)
+            indices.remove(keys[i]);
+    });
+
+    std::cout << "n = " << n << "\tBinarySearchTree insert: " << ptrInsert << " ms\tremove n/2: " << ptrRemove << " ms"
+              << "\tCompactAvlTree insert: " << cmpInsert << " ms\tremove n/2: " << cmpRemove << " ms" << std::endl;
+}
+
+void benchCompact()
+{
+    std::cout << "== node layout: BinarySearchTree<int> (" << PointerNodeSize::value
+              << " bytes/node) vs CompactAvlTree<int> (" << CompactNodeSize::value << " bytes/node) ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        compactUpdates(n);
+    for (int n = 100000; n <= 10000000; n *= 10)
+        compact(n, 1000000);
+}
+
+/**
+ * @brief 用法: ./benchmark [suite]. 不带参数时运行全部测试.
+ *
+ */
+int main(int argc, char *argv[])
+{
+    const char *suite = argc > 1 ? argv[1] : "all";
+    bool all = std::strcmp(suite, "all") == 0;
+
+    if (all || std::strcmp(suite, "overhead") == 0)
+        benchOverhead();
+    if (all || std::strcmp(suite, "select") == 0)
+        benchSelect();
+    if (all || std::strcmp(suite, "aggregate") == 0)
+        benchAggregate();
+    if (all || std::strcmp(suite, "interval") == 0)
+        benchInterval();
+    if (all || std::strcmp(suite, "compact") == 0)
+        benchCompact();
+
+    return 0;
+}
@@ -3,7 +3,13 @@
 #include <cmath>
 #include <random>
 #include <vector>
+#include <algorithm>
+#include <numeric>
+#include <string>
 #include "BST.h"
+#include "IntervalTree.h"
+#include "CompactAvl.h"
+#include <set>
 using namespace std;
 
 class MyData{
@@ -54,10 +60,34 @@ public:
         auto p = root;
         for(int i = 2; i <= N; i++){
             p->right = new node(i, nullptr, nullptr);
+            p->right->parent = p;
             p = p->right;
             p->height = N - i + 1;
         }
     }
+
+    Checker() {}
+    explicit Checker(BinarySearchTree<int> &&t) : BinarySearchTree<int>(std::move(t)) {}
+
+    // 检查每个节点的 height 和父指针是否正确, 左右子树高度差是否不超过 1
+    bool isAvl() const {
+        return check(root) != -2;
+    }
+
+    int height() const {
+        return root == nullptr ? -1 : root->height;
+    }
+
+private:
+    // 返回子树高度, 不合法时返回 -2. 只用于平衡的树, 递归深度不大
+    static int check(node *t){
+        if(t == nullptr) return -1;
+        int l = check(t->left), r = check(t->right);
+        if(l == -2 || r == -2 || l - r > 1 || r - l > 1) return -2;
+        if((t->left && t->left->parent != t) || (t->right && t->right->parent != t)) return -2;
+        int h = (l > r ? l : r) + 1;
+        return h == t->height ? h : -2;
+    }
 };
 
 void testRandomData(){
@@ -87,8 +117,322 @@ void testIncreasingData(){
     bst.printTree();
 }
 
+void testBulkLoad(){
+    cout << "------------------------------" << endl;
+    // 有序数据直接建成平衡的树, 重复的元素只保留一个
+    vector<int> sorted;
+    for(int i = 1; i <= 12; i++){
+        sorted.push_back(i);
+        if(i % 4 == 0) sorted.push_back(i);
+    }
+    Checker bst(BinarySearchTree<int>::from_sorted(sorted.begin(), sorted.end()));
+    bst.printTree();
+    cout << bst.isAvl() << " " << bst.height() << endl;    // 1 3
+    bst.insert(13);
+    bst.remove(1);
+    cout << bst.isAvl() << endl;    // 1
+
+    // 退化的链原地重建, 高度为 floor(log2 N), 之后的删除都是 O(log N)
+    const int N = 300000;
+    Checker chain;
+    chain.createChain(N);
+    chain.rebuild();
+    cout << chain.isAvl() << " " << chain.height() << endl;  // 1 18
+    for(int i = N; i >= 1; i--)
+        chain.remove(i);
+    chain.printTree();
+}
+
+void testIterators(){
+    cout << "------------------------------" << endl;
+    // 随机插入删除之后, 中序迭代器按顺序走遍所有元素, 区间查询只访问区间附近的节点
+    const int N = 100000;
+    mt19937 rnd(20241029);
+    Checker bst;
+    vector<int> keys;
+    for(int i = 0; i < N; i++){
+        int x = rnd() % (4 * N);
+        bst.insert(x);
+        keys.push_back(x);
+    }
+    for(int i = 0; i < N; i += 2)
+        bst.remove(keys[i]);
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    vector<int> inTree(bst.begin(), bst.end());
+    bool ordered = is_sorted(inTree.begin(), inTree.end());
+    bool backward = true;
+    auto it = bst.end();
+    for(auto r = inTree.rbegin(); r != inTree.rend(); ++r)
+        backward = backward && *--it == *r;
+    vector<int> range;
+    bst.for_each_in_range(1000, 5000, [&range](int x){ range.push_back(x); });
+    auto lo = std::lower_bound(inTree.begin(), inTree.end(), 1000);
+    auto hi = std::upper_bound(inTree.begin(), inTree.end(), 5000);
+    cout << bst.isAvl() << " " << ordered << " " << backward << " " << (it == bst.begin()) << " "
+         << (range == vector<int>(lo, hi)) << " "
+         << (*bst.upper_bound(inTree[10]) == inTree[11]) << endl;    // 1 1 1 1 1 1
+
+    // 拷贝和重建之后父指针仍然正确
+    Checker copy{BinarySearchTree<int>{bst}};
+    copy.rebuild();
+    cout << copy.isAvl() << " " << equal(copy.begin(), copy.end(), inTree.begin(), inTree.end()) << endl; // 1 1
+}
+
+void testOrderStatistics(){
+    cout << "------------------------------" << endl;
+    // 子树大小随插入、删除、旋转维护, 与排好序的 vector 对照
+    const int N = 50000;
+    mt19937 rnd(12345);
+    BinarySearchTree<int, OrderStatistics> bst;
+    vector<int> keys;
+    for(int i = 0; i < N; i++){
+        int x = rnd() % (4 * N);
+        bst.insert(x);
+        keys.push_back(x);
+    }
+    for(int i = 0; i < N; i += 3)
+        bst.remove(keys[i]);
+    vector<int> sorted(bst.begin(), bst.end());
+    bool ok = bst.size() == (int)sorted.size();
+    for(int k = 0; k < (int)sorted.size(); k++)
+        ok = ok && bst.select(k) == sorted[k];
+    for(int i = 0; i < 10000; i++){
+        int lo = rnd() % (4 * N), hi = lo + rnd() % 1000;
+        int below = std::lower_bound(sorted.begin(), sorted.end(), lo) - sorted.begin();
+        int inRange = std::upper_bound(sorted.begin(), sorted.end(), hi) - sorted.begin() - below;
+        ok = ok && bst.rank(lo) == below && bst.count_in_range(lo, hi) == inRange;
+    }
+    cout << ok << " " << bst.count_in_range(10, 5) << endl;    // 1 0
+
+    // 拷贝和重建都保留子树大小
+    vector<int> scores = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    auto board = BinarySearchTree<int, OrderStatistics>::from_sorted(scores.begin(), scores.end());
+    BinarySearchTree<int, OrderStatistics> copy = board;
+    copy.remove(50);
+    copy.insert(55);
+    copy.rebuild();
+    cout << board.select(4) << " " << copy.select(4) << " " << board.rank(75) << " "
+         << copy.count_in_range(30, 60) << " " << copy.size() << endl;  // 50 55 7 4 10
+    try{
+        board.select(10);
+    }catch(const ArrayIndexOutOfBoundsException &){
+        cout << "select out of range rejected" << endl;
+    }
+}
+
+// 不满足交换律的策略: 把元素按中序拼成字符串, 用来检查 combine 的顺序
+template <typename T>
+struct Concat{
+    using value_type = string;
+    static constexpr bool enabled = true;
+    static string identity(){ return ""; }
+    static string of(const T &x){ return to_string(x) + ","; }
+    static string combine(const string &a, const string &b){ return a + b; }
+};
+
+void testAugment(){
+    cout << "------------------------------" << endl;
+    // 区间和经过随机插入删除和各种旋转之后, 与排好序的 vector 上的暴力求和对照
+    const int N = 20000;
+    mt19937 rnd(24);
+    BinarySearchTree<long long, SubtreeSum> bst;
+    vector<long long> keys;
+    for(int i = 0; i < N; i++){
+        long long x = rnd() % (4 * N);
+        bst.insert(x);
+        keys.push_back(x);
+    }
+    for(int i = 0; i < N; i += 3)
+        bst.remove(keys[i]);
+    vector<long long> sorted(bst.begin(), bst.end());
+    bool ok = bst.aggregate() == accumulate(sorted.begin(), sorted.end(), 0LL);
+    for(int i = 0; i < 2000; i++){
+        long long lo = rnd() % (4 * N), hi = lo + rnd() % (N / 2);
+        auto first = std::lower_bound(sorted.begin(), sorted.end(), lo);
+        auto last = std::upper_bound(sorted.begin(), sorted.end(), hi);
+        ok = ok && bst.aggregate(lo, hi) == accumulate(first, last, 0LL);
+    }
+    BinarySearchTree<long long, SubtreeSum> copy = bst;
+    copy.rebuild();
+    cout << ok << " " << (copy.aggregate(100, 5000) == bst.aggregate(100, 5000)) << " "
+         << bst.aggregate(10, 5) << endl;   // 1 1 0
+
+    // 结果按中序拼接, 说明左右边界上的值拼在了正确的一侧
+    BinarySearchTree<int, Concat> words;
+    for(int x : {5, 3, 8, 1, 4, 7, 9, 2, 6})
+        words.insert(x);
+    words.remove(5);
+    cout << words.aggregate() << " " << words.aggregate(2, 7) << endl;  // 1,2,3,4,6,7,8,9, 2,3,4,6,7,
+
+    BinarySearchTree<int, SubtreeMin> mins;
+    BinarySearchTree<int, SubtreeMax> maxs;
+    for(int x : {40, -3, 17, 99, 8}){
+        mins.insert(x);
+        maxs.insert(x);
+    }
+    cout << mins.aggregate(0, 50) << " " << maxs.aggregate(0, 50) << endl;   // 8 40
+
+    // 顺序统计树就是用 OrderStatistics 策略增强的树, 区间聚合就是区间中的元素个数
+    OrderStatisticsTree<int> ranks;
+    for(int i = 0; i < 100; i++)
+        ranks.insert(i * 2);
+    cout << ranks.aggregate(10, 20) << " " << ranks.count_in_range(10, 20) << endl;    // 6 6
+}
+
+void testIntervalTree(){
+    cout << "------------------------------" << endl;
+    // 与逐个检查所有区间的暴力做法对照
+    const int N = 20000;
+    mt19937 rnd(2024);
+    IntervalTree<int> tree;
+    vector<Interval<int>> all;
+    for(int i = 0; i < N; i++){
+        int lo = rnd() % 1000000, len = rnd() % 2000;
+        tree.insert(lo, lo + len);
+        all.push_back({lo, lo + len});
+    }
+    for(int i = 0; i < N; i += 4)
+        tree.remove(all[i]);
+    vector<Interval<int>> live(tree.begin(), tree.end());
+    bool ok = true;
+    for(int q = 0; q < 1000; q++){
+        int lo = rnd() % 1000000, hi = lo + rnd() % 500;
+        vector<Interval<int>> expected, found;
+        for(const auto &iv : live)
+            if(iv.overlaps(lo, hi)) expected.push_back(iv);
+        tree.for_each_overlapping(lo, hi, [&found](const Interval<int> &iv){ found.push_back(iv); });
+        const Interval<int> *any = tree.any_overlapping(lo, hi);
+        ok = ok && found == expected && (any == nullptr) == expected.empty()
+                && (any == nullptr || any->overlaps(lo, hi));
+    }
+    int maxEnd = 0;
+    for(const auto &iv : live)
+        maxEnd = max(maxEnd, iv.hi);
+    cout << ok << " " << (tree.max_end() == maxEnd) << endl;  // 1 1
+
+    IntervalTree<int> small;
+    small.insert(15, 20);
+    small.insert(10, 30);
+    small.insert(17, 19);
+    small.insert(5, 20);
+    small.insert(12, 15);
+    small.insert(30, 40);
+    small.for_each_containing(16, [](const Interval<int> &iv){ cout << iv << " "; });
+    cout << endl;   // [5,20] [10,30] [15,20]
+    cout << (small.any_overlapping(41, 50) == nullptr) << endl;   // 1
+    try{
+        small.insert(3, 1);
+    }catch(const IllegalArgumentException &){
+        cout << "empty interval rejected" << endl;
+    }
+}
+
+class CompactChecker : public CompactAvlTree<int>{
+public:
+    CompactChecker() {}
+    explicit CompactChecker(CompactAvlTree<int> &&t) : CompactAvlTree<int>(std::move(t)) {}
+
+    // 检查平衡因子是否等于左右子树的高度差, 元素个数是否正确
+    bool isAvl() const {
+        int count = 0;
+        return check(root, count) != -2 && count == theSize;
+    }
+
+    int height() const {
+        int count = 0;
+        return check(root, count);
+    }
+
+    // 根和它的两个子节点是否按层序排在数组的最前面
+    bool bfsLayout() const {
+        return root == 1 && (theSize < 3 || (node(1).left == 2 && node(1).right == 3));
+    }
+
+    static size_t nodeSize(){
+        return sizeof(Node);
+    }
+
+private:
+    int check(Index t, int &count) const {
+        if(t == NIL) return -1;
+        ++count;
+        int l = check(node(t).left, count), r = check(node(t).right, count);
+        if(l == -2 || r == -2 || r - l != node(t).balance()) return -2;
+        return (l > r ? l : r) + 1;
+    }
+};
+
+void testCompactAvl(){
+    cout << "------------------------------" << endl;
+    // 随机插入删除, 与 std::set 对照, 每一步之后平衡因子都要和实际高度一致
+    const int N = 100000;
+    mt19937 rnd(7);
+    CompactChecker bst;
+    set<int> ref;
+    bool ok = true;
+    for(int i = 0; i < N; i++){
+        int x = rnd() % 5000;
+        if(rnd() % 3 == 0){
+            bst.remove(x);
+            ref.erase(x);
+        }else{
+            bst.insert(x);
+            ref.insert(x);
+        }
+        if(i % 1000 == 0) ok = ok && bst.isAvl();
+        ok = ok && bst.contains(x) == (ref.count(x) == 1);
+    }
+    vector<int> inTree;
+    bst.for_each([&inTree](int x){ inTree.push_back(x); });
+    vector<int> range;
+    bst.for_each_in_range(1000, 2000, [&range](int x){ range.push_back(x); });
+    ok = ok && bst.isAvl() && inTree == vector<int>(ref.begin(), ref.end()) && bst.size() == (int)ref.size()
+            && range == vector<int>(ref.lower_bound(1000), ref.upper_bound(2000));
+    bst.rebuild();
+    vector<int> rebuilt;
+    bst.for_each([&rebuilt](int x){ rebuilt.push_back(x); });
+    cout << ok << " " << bst.isAvl() << " " << bst.bfsLayout() << " " << (rebuilt == inTree) << " "
+         << (bst.findMin() == *ref.begin()) << " " << (bst.findMax() == *ref.rbegin()) << endl;  // 1 1 1 1 1 1
+
+    // 有序建树, 删除之后复用空闲节点, 拷贝互不影响
+    vector<int> sorted;
+    for(int i = 1; i <= 12; i++){
+        sorted.push_back(i);
+        if(i % 4 == 0) sorted.push_back(i);
+    }
+    CompactChecker small(CompactAvlTree<int>::from_sorted(sorted.begin(), sorted.end()));
+    small.printTree();
+    cout << small.isAvl() << " " << small.height() << " " << small.bfsLayout() << endl;   // 1 3 1
+    CompactAvlTree<int> copy = small;
+    small.remove(6);
+    small.insert(13);
+    cout << small.isAvl() << " " << small.contains(6) << " " << copy.contains(6) << " "
+         << small.size() << " " << copy.size() << endl;   // 1 0 1 12 12
+    cout << CompactChecker::nodeSize() << endl;    // 12
+
+    // 移动之后源树是一棵可以继续使用的空树
+    CompactAvlTree<int> moved = std::move(copy);
+    cout << copy.isEmpty() << " " << copy.size() << " " << moved.size() << " ";
+    copy.insert(42);
+    copy = std::move(moved);
+    moved.insert(7);
+    cout << copy.size() << " " << copy.contains(6) << " " << moved.size() << " " << moved.contains(7) << endl;  // 1 0 12 12 1 1 1
+    try{
+        CompactAvlTree<int>().findMin();
+    }catch(const UnderflowException &){
+        cout << "findMin on empty tree rejected" << endl;
+    }
+}
+
 int main(){
     testRandomData();
     testIncreasingData();
+    testBulkLoad();
+    testIterators();
+    testOrderStatistics();
+    testAugment();
+    testIntervalTree();
+    testCompactAvl();
     return 0;
 }
\ No newline at end of file
@@ -9,7 +9,12 @@
  * 
  */
 
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 /// 临时性的异常类，用于表示树为空的异常
 class UnderflowException { };
@@ -27,7 +32,143 @@ class IteratorUninitializedException { };
 template <typename Comparable>
 class BinarySearchTree
 {
+protected:
+    struct BinaryNode;  // 迭代器中要用到，定义在后面
+
 public:
+    /**
+     * @brief 中序遍历的只读双向迭代器
+     * 
+     * 节点里存有父指针，所以不需要栈：有右子树时 ++ 走到右子树的最左节点，否则沿父指针向上，
+     * 直到从某个节点的左子树上来，-- 与之对称。每条边最多向下、向上各走一次，所以遍历整棵树是
+     * O(n) 的，单次 ++ 均摊 O(1)。元素决定了节点在树中的位置，因此不能通过迭代器修改元素。
+     * 
+     * 插入不会使迭代器失效；删除只使指向被删元素的迭代器失效，其它节点只是被重新链接，不会被移动。
+     */
+    class const_iterator
+    {
+    public:
+        /// 标准库的算法通过 std::iterator_traits 读取这几个类型
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Comparable;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Comparable *;
+        using reference = const Comparable &;
+
+        /**
+         * @brief 默认构造函数，得到一个未初始化的迭代器，使用它会抛出 IteratorUninitializedException
+         */
+        const_iterator() : current{ nullptr }, tree{ nullptr } {}
+
+        /**
+         * @brief 返回当前元素，对 end() 解引用抛出 IteratorOutOfBoundsException
+         * 
+         * @return 当前元素的常量引用
+         */
+        const Comparable &operator*() const {
+            assertIsValid();
+            if (current == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            return current->element;
+        }
+
+        const Comparable *operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief 移到中序的下一个元素，end() 不能再向后移
+         * 
+         * @return 自身的引用
+         */
+        const_iterator &operator++() {
+            assertIsValid();
+            if (current == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            if (current->right != nullptr) {
+                /// 右子树中最小的元素
+                current = current->right;
+                while (current->left != nullptr)
+                    current = current->left;
+            } else {
+                /// 向上，直到从某个节点的左子树上来，那个节点就是下一个；走到根之上就是 end()
+                const BinaryNode *child = current;
+                current = current->parent;
+                while (current != nullptr && current->right == child) {
+                    child = current;
+                    current = current->parent;
+                }
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        /**
+         * @brief 移到中序的前一个元素。end() 的前一个是最大元素，begin() 不能再向前移
+         * 
+         * @return 自身的引用
+         */
+        const_iterator &operator--() {
+            assertIsValid();
+            const BinaryNode *p = current;
+            if (p == nullptr) {
+                p = tree->findMax(tree->root);
+            } else if (p->left != nullptr) {
+                /// 左子树中最大的元素
+                p = p->left;
+                while (p->right != nullptr)
+                    p = p->right;
+            } else {
+                const BinaryNode *child = p;
+                p = p->parent;
+                while (p != nullptr && p->left == child) {
+                    child = p;
+                    p = p->parent;
+                }
+            }
+            /// 空树的 end()，或者已经是 begin()
+            if (p == nullptr)
+                throw IteratorOutOfBoundsException{ };
+            current = p;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return current == rhs.current;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+    protected:
+        const BinaryNode *current;      ///< 当前节点，end() 为 nullptr
+        const BinarySearchTree *tree;   ///< 所属的树，从 end() 向前移时要用到
+
+        const_iterator(const BinaryNode *p, const BinarySearchTree *t) : current{ p }, tree{ t } {}
+
+        void assertIsValid() const {
+            if (tree == nullptr)
+                throw IteratorUninitializedException{ };
+        }
+
+        friend class BinarySearchTree<Comparable>;
+    };
+
+    /// 元素不能通过迭代器修改，所以 iterator 和 const_iterator 是同一个类型
+    using iterator = const_iterator;
+
     /**
      * @brief 默认构造函数
      * 
@@ -69,7 +210,7 @@ public:
     /**
      * @brief 查找并返回树中的最小元素
      * 
-     * 这是一个公有接口，它调用了私有的递归函数。
+     * 这是一个公有接口，它调用了私有的同名函数。
      * 
      * @return 最小元素的引用
      */
@@ -100,6 +241,77 @@ public:
         return contains(x, root);
     }
 
+    /**
+     * @brief 指向最小元素的迭代器，空树时等于 end()
+     */
+    const_iterator begin() const {
+        return { findMin(root), this };
+    }
+
+    /**
+     * @brief 最大元素之后的位置
+     */
+    const_iterator end() const {
+        return { nullptr, this };
+    }
+
+    /**
+     * @brief 第一个不小于 x 的元素，O(树高)
+     * 
+     * @param x 要比较的值
+     * @return 指向该元素的迭代器，不存在时为 end()
+     */
+    const_iterator lower_bound(const Comparable &x) const {
+        BinaryNode *t = root;
+        BinaryNode *result = nullptr;
+        while (t != nullptr) {
+            if (t->element < x) {
+                t = t->right;
+            } else {
+                result = t;     // t 是一个候选，更小的候选只可能在左子树中
+                t = t->left;
+            }
+        }
+        return { result, this };
+    }
+
+    /**
+     * @brief 第一个大于 x 的元素，O(树高)
+     * 
+     * @param x 要比较的值
+     * @return 指向该元素的迭代器，不存在时为 end()
+     */
+    const_iterator upper_bound(const Comparable &x) const {
+        BinaryNode *t = root;
+        BinaryNode *result = nullptr;
+        while (t != nullptr) {
+            if (x < t->element) {
+                result = t;
+                t = t->left;
+            } else {
+                t = t->right;
+            }
+        }
+        return { result, this };
+    }
+
+    /**
+     * @brief 按从小到大的顺序对闭区间 [lo, hi] 中的每个元素调用 f
+     * 
+     * 先用 lower_bound 找到起点，再逐个 ++ 直到超过 hi。区间外的子树都不会被访问，
+     * 总共访问 O(树高 + k) 个节点，k 为区间中的元素个数，不需要把整棵树拷贝出来。
+     * 
+     * @param lo 区间下界
+     * @param hi 区间上界
+     * @param f 以 const Comparable & 为参数的函数
+     */
+    template <typename Function>
+    void for_each_in_range(const Comparable &lo, const Comparable &hi, Function f) const {
+        for (const_iterator it = lower_bound(lo); it.current != nullptr && !(hi < it.current->element); ++it) {
+            f(it.current->element);
+        }
+    }
+
     /**
      * @brief 检查树是否为空
      * 
@@ -114,6 +326,9 @@ public:
      * 
      * 将树的结构输出到指定的输出流，默认输出到标准输出流。
      * 
+     * 这棵树不做平衡，有序插入时会退化成一条深度为 n 的链。所以下面所有私有的操作都是循环实现的，
+     * 不依赖函数调用栈，即使是 10^7 层深的树，用默认的栈大小也不会溢出。
+     * 
      * @param out 输出流，默认为 std::cout
      */
     void printTree(std::ostream &out = std::cout) const {
@@ -133,6 +348,53 @@ public:
         makeEmpty(root);
     }
 
+    /**
+     * @brief 由有序序列直接建一棵高度最小的树
+     * 
+     * 有序的数据逐个 insert 会退化成一条链，建树要 O(n^2)。这里先把元素依次接成一条
+     * 只有右子节点的链 (vine)，再用 DSW 算法的几轮左旋把它压成平衡的树，总共 O(n)，
+     * 除了节点本身不需要额外的空间。相等的相邻元素只保留第一个，和 insert 一样不存重复元素。
+     * 
+     * @tparam Iterator 输入迭代器，元素必须按 < 非降序排列，否则抛出 IllegalArgumentException
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return 建好的树
+     */
+    template <typename Iterator>
+    static BinarySearchTree from_sorted(Iterator first, Iterator last) {
+        BinarySearchTree tree;
+        BinaryNode **tail = &tree.root;
+        BinaryNode *prev = nullptr;
+        int n = 0;
+        /// 中途抛出异常时，已经接上的节点仍然是一棵合法的树，随 tree 一起析构
+        for (; first != last; ++first) {
+            if (prev != nullptr && !(prev->element < *first)) {
+                if (*first < prev->element) {
+                    throw IllegalArgumentException{ };
+                }
+                continue;   // 重复的元素
+            }
+            *tail = prev = new BinaryNode{*first, nullptr, nullptr};
+            tail = &prev->right;
+            ++n;
+        }
+        vineToTree(tree.root, n);
+        fixParents(tree.root);
+        return tree;
+    }
+
+    /**
+     * @brief 把现有的树原地整理成高度最小的树
+     * 
+     * 先用右旋把树拉直成一条链，再像 from_sorted 一样压回平衡的树。只修改指针，
+     * 不分配也不释放节点，元素不会被拷贝或移动，O(n) 时间。最后重新设置父指针时
+     * 用到一个深度为 O(log n) 的栈。
+     */
+    void rebuild() {
+        vineToTree(root, treeToVine(root));
+        fixParents(root);
+    }
+
     /**
      * @brief 插入一个常量引用元素到树中
      * 
@@ -190,7 +452,7 @@ public:
         return *this;
     }
 
-private:
+protected:
     /**
      * @brief 二叉树节点结构体
      */
@@ -199,6 +461,7 @@ private:
         Comparable element;  ///< 节点存储的元素
         BinaryNode *left;    ///< 左子节点指针
         BinaryNode *right;   ///< 右子节点指针
+        BinaryNode *parent = nullptr;  ///< 父节点指针，根节点为 nullptr，供迭代器向上走
 
         /**
          * @brief 构造函数，接受常量引用
@@ -224,7 +487,7 @@ private:
     BinaryNode *root;  ///< 树的根节点指针
 
     /**
-     * @brief 递归查找最小元素
+     * @brief 查找最小元素
      * 
      * @param t 当前节点指针
      * @return 最小元素所在的节点指针
@@ -234,23 +497,21 @@ private:
         if (t == nullptr) {
             return nullptr;
         }
-        /// 向左无路了，当前节点就是最小元素
-        if (t->left == nullptr) {
-            return t;
+        /// 一直向左，直到向左无路，那个节点就是最小元素
+        while (t->left != nullptr) {
+            t = t->left;
         }
-        /// 否则继续向左查找
-        return findMin(t->left);
+        return t;
     }
 
     /**
-     * @brief 递归查找最大元素
+     * @brief 查找最大元素
      * 
      * @param t 当前节点指针
      * @return 最大元素所在的节点指针
      */
     BinaryNode *findMax(BinaryNode *t) const {
-        /// 这里没有使用递归，而是使用循环，更高效
-        /// findMin 也可以改成循环实现
+        /// 和 findMin 一样用循环，不用递归
         if (t != nullptr) {
             while (t->right != nullptr) {
                 t = t->right;
@@ -260,79 +521,210 @@ private:
     }
 
     /**
-     * @brief 递归检查树中是否包含指定的元素
+     * @brief 检查树中是否包含指定的元素
      * 
      * @param x 要查找的元素
      * @param t 当前节点指针
      * @return 如果树中包含该元素，则返回 true；否则返回 false
      */
     bool contains(const Comparable &x, BinaryNode *t) const {
-        /// 这是递归版本，也可以有循环版本
-        if (t == nullptr) {
-            return false;
-        }
-        if (x < t->element) {
-            return contains(x, t->left);
-        } 
-        else if (x > t->element) {
-            return contains(x, t->right);
-        } 
-        else {
-            return true;  // 找到元素
+        /// 递归版本的每一层只是换一个 t 继续比较，直接写成循环
+        while (t != nullptr) {
+            if (x < t->element) {
+                t = t->left;
+            } 
+            else if (x > t->element) {
+                t = t->right;
+            } 
+            else {
+                return true;  // 找到元素
+            }
         }
+        return false;
     }
 
     /**
-     * @brief 递归打印树的结构
+     * @brief 中序打印树中的元素
+     * 
+     * 用一个显式的栈代替递归：栈里是还没有打印、但左子树已经在处理的祖先节点。
+     * 不像 Morris 遍历那样临时修改右指针，所以 const 的树可以被多个线程同时打印。
      * 
      * @param t 当前节点指针
      * @param out 输出流
      */
     void printTree(BinaryNode *t, std::ostream &out) const {
-        /// 中序遍历
-        if (t != nullptr) {
-            printTree(t->left, out);  // 先打印左子树
-            out << t->element << std::endl;  // 打印当前节点
-            printTree(t->right, out);  // 再打印右子树
+        std::vector<BinaryNode *> stack;
+        while (t != nullptr || !stack.empty()) {
+            /// 先一路向左，沿途的节点都要等左子树打印完
+            while (t != nullptr) {
+                stack.push_back(t);
+                t = t->left;
+            }
+            t = stack.back();
+            stack.pop_back();
+            out << t->element << '\n';  // 打印当前节点
+            t = t->right;  // 再打印右子树
         }
+        out.flush();
     }
 
     /**
-     * @brief 递归清空树中的所有元素
+     * @brief 清空树中的所有元素
+     * 
+     * 递归版本必须是后序遍历：先删子树再删自己，否则删掉 t 之后就找不到它的子树了。
+     * 这里不需要栈：t 有左子树时先右旋一次，把左子节点转上来；没有左子树时 t 就可以删了，
+     * 接着处理它的右子树。每个节点最多被转上来一次，总共 O(n)，不需要额外的空间。
+     * 
+     * 它不访问树本身的成员，所以是静态的，const 的 clone 也可以用它回收拷贝了一半的节点。
      * 
      * @param t 当前节点指针
      */
-    void makeEmpty(BinaryNode * &t) {
-        /// 这必须是一个后序遍历，为什么？
-        if (t != nullptr) {
-            makeEmpty(t->left);
-            makeEmpty(t->right);
-            delete t;
-            /// delete 并不会自动将指针置空，这里需要手动置空
-            t = nullptr;
+    static void makeEmpty(BinaryNode * &t) {
+        while (t != nullptr) {
+            if (t->left != nullptr) {
+                BinaryNode *l = t->left;
+                t->left = l->right;
+                l->right = t;
+                t = l;
+            } else {
+                BinaryNode *r = t->right;
+                delete t;
+                t = r;
+            }
+        }
+        /// 循环结束时 t 已经是 nullptr 了
+    }
+
+    /**
+     * @brief 用右旋把以 t 为根的树拉直成一条只有右子节点的链 (vine)，元素的顺序不变
+     * 
+     * @param t 当前节点指针
+     * @return 节点个数
+     */
+    static int treeToVine(BinaryNode * &t) {
+        int n = 0;
+        BinaryNode **p = &t;
+        while (*p != nullptr) {
+            if ((*p)->left != nullptr) {
+                /// 左子节点转上来，原来的节点成为它的右子节点
+                BinaryNode *l = (*p)->left;
+                (*p)->left = l->right;
+                l->right = *p;
+                *p = l;
+            } else {
+                ++n;
+                p = &(*p)->right;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief 从链头开始，每隔一个节点做一次左旋，共做 count 次，链的长度大约减半
+     * 
+     * @param t 链头指针
+     * @param count 左旋次数
+     */
+    static void compress(BinaryNode * &t, int count) {
+        BinaryNode **p = &t;
+        for (int i = 0; i < count; ++i) {
+            BinaryNode *child = *p;
+            BinaryNode *r = child->right;
+            child->right = r->left;
+            r->left = child;
+            *p = r;
+            p = &r->right;
+        }
+    }
+
+    /**
+     * @brief DSW 算法的第二步：把长为 n 的链压成平衡的树
+     * 
+     * 先把多出满二叉树 (2^k - 1 个节点) 的那些节点压到最底层，剩下的正好是满二叉树的形状，
+     * 每一轮压缩让链的长度减半，最后所有叶子的深度至多相差 1，树高为 floor(log2 n)。
+     * 
+     * @param t 链头指针
+     * @param n 节点个数
+     */
+    static void vineToTree(BinaryNode * &t, int n) {
+        int full = 1;
+        while (full * 2 + 1 <= n) {
+            full = full * 2 + 1;
+        }
+        compress(t, n - full);
+        for (int m = full / 2; m > 0; m /= 2) {
+            compress(t, m);
+        }
+    }
+
+    /**
+     * @brief 重新设置以 t 为根的整棵树的父指针，t 的父指针置为 nullptr
+     * 
+     * 拉直和压缩时旋转得太多，逐个维护父指针不如最后统一设置一遍。只在树已经平衡之后调用，
+     * 栈的深度不超过树高。
+     * 
+     * @param t 根节点指针
+     */
+    static void fixParents(BinaryNode *t) {
+        if (t == nullptr) {
+            return;
+        }
+        t->parent = nullptr;
+        std::vector<BinaryNode *> stack{ t };
+        while (!stack.empty()) {
+            BinaryNode *n = stack.back();
+            stack.pop_back();
+            for (BinaryNode *c : { n->left, n->right }) {
+                if (c != nullptr) {
+                    c->parent = n;
+                    stack.push_back(c);
+                }
+            }
         }
     }
 
     /**
-     * @brief 递归插入一个常量引用元素到树中
+     * @brief 找到 x 应该在的位置
+     * 
+     * 递归版本传下去的是父节点里左指针或右指针的引用，这里用指向它的指针 (指针的指针) 代替，
+     * 每往下走一层只是换一个指针，不需要递归。
+     * 
+     * @param x 要查找的元素
+     * @param t 子树根节点指针的引用
+     * @param parent 返回的那个指针所在的节点，也就是新节点的父节点
+     * @return 指向 x 所在节点的那个指针；x 不存在时，是 x 插入后应该挂上去的那个空指针
+     */
+    BinaryNode **findSlot(const Comparable &x, BinaryNode * &t, BinaryNode * &parent) {
+        BinaryNode **p = &t;
+        parent = (t != nullptr) ? t->parent : nullptr;
+        while (*p != nullptr) {
+            if (x < (*p)->element) {
+                parent = *p;
+                p = &(*p)->left;
+            } else if (x > (*p)->element) {
+                parent = *p;
+                p = &(*p)->right;
+            } else {
+                break;  // 找到元素
+            }
+        }
+        return p;
+    }
+
+    /**
+     * @brief 插入一个常量引用元素到树中
      * 
      * @param x 要插入的元素
      * @param t 当前节点指针
      */
     void insert(const Comparable &x, BinaryNode * &t) {
-        /// 这句话乍一看不可思异，怎么能对一个空指针赋值呢？
-        /// 但是这里是引用，所以实际上是对指针 t 的引用，t 现在存了 nullptr, 
-        /// 所以可以修改指针 t 的值
-        if (t == nullptr) {
-            /// 创建一个新节点，包含 x 的值，左右子节点为空
-            /// 挂在 t 指向的节点上
-            /// 而在递归过程中，t 总是会指向父节点的左子节点或右子节点
-            /// 所以这里实际上是将新节点挂在父节点的左子节点或右子节点上
-            t = new BinaryNode{x, nullptr, nullptr};
-        } else if (x < t->element) {
-            insert(x, t->left);
-        } else if (x > t->element) {
-            insert(x, t->right);
+        BinaryNode *parent;
+        BinaryNode **p = findSlot(x, t, parent);
+        /// *p 就是父节点的左指针或右指针 (或者 t 本身)，它现在存了 nullptr,
+        /// 把新节点赋给它，新节点就挂在了父节点上
+        if (*p == nullptr) {
+            *p = new BinaryNode{x, nullptr, nullptr};
+            (*p)->parent = parent;
         } else {
             /// 如果元素已存在，则不进行插入
             /// 这种情况不可遗漏，严格的规则中也可以抛出异常
@@ -340,21 +732,18 @@ private:
     }
 
     /**
-     * @brief 递归插入一个右值引用元素到树中
+     * @brief 插入一个右值引用元素到树中
      * 
      * @param x 要插入的元素
      * @param t 当前节点指针
      */
     void insert(Comparable &&x, BinaryNode * &t) {
         /// 一样的逻辑
-        if (t == nullptr) {
-            t = new BinaryNode{std::move(x), nullptr, nullptr};
-        } else if (x < t->element) {
-            insert(std::move(x), t->left);
-        } else if (x > t->element) {
-            insert(std::move(x), t->right);
-        } else {
-            // 如果元素已存在，则不进行插入
+        BinaryNode *parent;
+        BinaryNode **p = findSlot(x, t, parent);
+        if (*p == nullptr) {
+            *p = new BinaryNode{std::move(x), nullptr, nullptr};
+            (*p)->parent = parent;
         }
     }
 
@@ -364,63 +753,85 @@ private:
      * @param t 当前节点指针
      */
     BinaryNode *detachMin(BinaryNode *&t) {
-        if (t == nullptr)
+        BinaryNode **p = &t;
+        if (*p == nullptr)
             return nullptr;
-        if (t->left != nullptr)
-            return detachMin(t->left);
-        else {
-            BinaryNode *minNode = t;
-            t = t->right;
-            return minNode;
+        while ((*p)->left != nullptr)
+            p = &(*p)->left;
+        BinaryNode *minNode = *p;
+        *p = minNode->right;
+        if (*p != nullptr) {
+            (*p)->parent = minNode->parent;
         }
+        return minNode;
     }
 
     /**
-     * @brief 递归从树中移除指定的元素
+     * @brief 从树中移除指定的元素
      * 
      * @param x 要移除的元素
      * @param t 当前节点指针
      */
     void remove(const Comparable &x, BinaryNode * &t) {
         /// 这个逻辑其实是 find and remove, 从 t 开始
-        if (t == nullptr) {
+        BinaryNode *parent;
+        BinaryNode **p = findSlot(x, t, parent);
+        BinaryNode *oldNode = *p;
+        if (oldNode == nullptr) {
             return;  /// 元素不存在
         }
-        if (x < t->element) {
-            remove(x, t->left);
-        } else if (x > t->element) {
-            remove(x, t->right);
-        } 
-        /// 进入以下这两个分支，都是说明找到了要删除的元素
-        else if (t->left != nullptr && t->right != nullptr) {  /// 有两个子节点
-            BinaryNode *oldNode = t;
-            // 找到替换节点，并将当前节点的信息传递给该节点
-            t = detachMin(t->right); 
-            t->left = oldNode->left; 
-            if(oldNode->right == t)    // 如果替换的节点正好是右子节点，则应为右子节点的右子节点(包含了nullptr的情况)
-                t->right = oldNode->right->right; 
-            else
-                t->right = oldNode->right;
-            delete oldNode;
+        if (oldNode->left != nullptr && oldNode->right != nullptr) {  /// 有两个子节点
+            /// 用右子树的最小节点顶替被删的节点。摘下它时已经修改了 oldNode->right
+            /// (它正好是右子节点时，oldNode->right 变成了它的右子节点)，直接接过来即可
+            BinaryNode *minNode = detachMin(oldNode->right);
+            minNode->left = oldNode->left;
+            minNode->right = oldNode->right;
+            minNode->left->parent = minNode;
+            if (minNode->right != nullptr) {
+                minNode->right->parent = minNode;
+            }
+            *p = minNode;
         } else {
             /// 有一个或没有子节点的情形是简单的
-            BinaryNode *oldNode = t;
-            t = (t->left != nullptr) ? t->left : t->right;
-            delete oldNode;
+            *p = (oldNode->left != nullptr) ? oldNode->left : oldNode->right;
+        }
+        if (*p != nullptr) {
+            (*p)->parent = oldNode->parent;
         }
+        delete oldNode;
     }
 
     /**
-     * @brief 递归克隆树的结构
+     * @brief 克隆树的结构
+     * 
+     * 不用递归，也不用原树的父指针：栈里放的是 "原树中的一个节点，它的拷贝应该挂到的那个指针，
+     * 以及那个指针所在的新节点"。每拷贝一个节点，就把它的两个子节点连同新节点的左右指针压栈。
+     * 中途分配失败时，已经拷贝好的部分都挂在 copy 上，整体释放后再把异常抛出去。
      * 
      * @param t 当前节点指针
      * @return 新的节点指针
      */
     BinaryNode *clone(BinaryNode *t) const {
-        if (t == nullptr) {
-            return nullptr;
+        BinaryNode *copy = nullptr;
+        std::vector<std::tuple<const BinaryNode *, BinaryNode **, BinaryNode *>> stack;
+        stack.push_back({t, &copy, nullptr});
+        try {
+            while (!stack.empty()) {
+                auto [from, to, parent] = stack.back();
+                stack.pop_back();
+                if (from == nullptr) {
+                    continue;
+                }
+                *to = new BinaryNode{from->element, nullptr, nullptr};
+                (*to)->parent = parent;
+                stack.push_back({from->right, &(*to)->right, *to});
+                stack.push_back({from->left, &(*to)->left, *to});
+            }
+        } catch (...) {
+            makeEmpty(copy);
+            throw;
         }
-        return new BinaryNode{t->element, clone(t->left), clone(t->right)};
+        return copy;
     }
 };
 
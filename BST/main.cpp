@@ -1,6 +1,47 @@
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "BinarySearchTree.h"  // 假设 BinarySearchTree 类定义在这个头文件中
 
+/// 直接接出一条 n 层深的链，leftward 时是递减的左链，否则是递增的右链。
+/// 有序插入得到的也是这样的链，但是要 O(n^2) 的时间
+class Chain : public BinarySearchTree<int> {
+public:
+    Chain(int n, bool leftward) {
+        BinaryNode **p = &root;
+        BinaryNode *parent = nullptr;
+        for (int i = 1; i <= n; i++) {
+            *p = new BinaryNode{leftward ? n + 1 - i : i, nullptr, nullptr};
+            (*p)->parent = parent;
+            parent = *p;
+            p = leftward ? &(*p)->left : &(*p)->right;
+        }
+    }
+
+    explicit Chain(BinarySearchTree<int> &&t) : BinarySearchTree<int>(std::move(t)) {}
+
+    /// 树高，按层遍历，空树为 -1
+    int height() const {
+        int h = -1;
+        std::vector<BinaryNode *> level;
+        if (root != nullptr)
+            level.push_back(root);
+        while (!level.empty()) {
+            std::vector<BinaryNode *> next;
+            for (BinaryNode *t : level) {
+                if (t->left != nullptr) next.push_back(t->left);
+                if (t->right != nullptr) next.push_back(t->right);
+            }
+            level.swap(next);
+            h++;
+        }
+        return h;
+    }
+};
+
 void testBinarySearchTree() {
     BinarySearchTree<int> bst;
 
@@ -37,7 +78,116 @@ void testBinarySearchTree() {
     bst.printTree();
 }
 
+void testDegenerateTree() {
+    /// 所有操作都不递归，10^7 层深的树用默认的栈也不会溢出
+    const int N = 10000000;
+    Chain right(N, false);
+    std::cout << right.findMin() << " " << right.findMax() << " "
+              << right.contains(N) << " " << right.contains(N + 1) << std::endl; // 1 10000000 1 0
+    right.insert(N + 1);    // 挂在链的最底下
+    right.remove(N);
+    right.remove(1);
+    BinarySearchTree<int> copy = right;
+    right.makeEmpty();
+    std::cout << right.isEmpty() << " " << copy.findMin() << " " << copy.findMax() << " "
+              << copy.contains(N) << std::endl;   // 1 2 10000001 0
+
+    Chain left(N, true);
+    left.insert(0);
+    std::ostringstream out;
+    left.printTree(out);
+    std::string s = out.str();
+    std::cout << std::count(s.begin(), s.end(), '\n') << " "
+              << s.substr(0, s.find('\n')) << std::endl;     // 10000001 0
+    /// left 析构时从最深处一路右旋回来
+}
+
+void testBulkLoad() {
+    /// 有序数据直接建树，O(n)，重复的元素只保留一个
+    std::vector<int> sorted = {1, 2, 2, 3, 4, 5, 6, 7, 7, 7, 8, 9, 10};
+    Chain small(BinarySearchTree<int>::from_sorted(sorted.begin(), sorted.end()));
+    std::cout << "Tree from sorted input:" << std::endl;
+    small.printTree();      // 1 到 10 各一行
+    std::cout << small.height() << " " << small.contains(7) << std::endl;  // 3 1
+    std::vector<int> unsorted = {1, 3, 2};
+    try {
+        BinarySearchTree<int>::from_sorted(unsorted.begin(), unsorted.end());
+    } catch (const IllegalArgumentException &) {
+        std::cout << "unsorted input rejected" << std::endl;
+    }
+    Chain empty(BinarySearchTree<int>::from_sorted(unsorted.begin(), unsorted.begin()));
+    std::cout << empty.isEmpty() << " " << empty.height() << std::endl;   // 1 -1
+
+    /// 退化的链原地重建，不重新分配节点
+    const int N = 10000000;
+    Chain left(N, true);
+    left.rebuild();
+    std::cout << left.height() << " " << left.findMin() << " " << left.findMax() << " "
+              << left.contains(N / 2) << std::endl;     // 23 1 10000000 1
+    Chain right(1000, false);
+    right.remove(500);
+    right.rebuild();
+    std::cout << right.height() << " " << right.contains(500) << std::endl;  // 9 0
+}
+
+void testIterators() {
+    /// 中序迭代器和区间查询
+    std::vector<int> keys = {50, 30, 70, 20, 40, 60, 80, 35, 45, 65};
+    BinarySearchTree<int> bst;
+    for (int k : keys)
+        bst.insert(k);
+    for (int x : bst)
+        std::cout << x << " ";
+    std::cout << std::endl;     // 20 30 35 40 45 50 60 65 70 80
+    for (auto it = bst.end(); it != bst.begin(); )
+        std::cout << *--it << " ";
+    std::cout << std::endl;     // 80 70 65 60 50 45 40 35 30 20
+    std::cout << *bst.lower_bound(36) << " " << *bst.lower_bound(40) << " "
+              << *bst.upper_bound(40) << " " << (bst.upper_bound(80) == bst.end()) << " "
+              << std::distance(bst.begin(), bst.lower_bound(50)) << std::endl;  // 40 40 45 1 5
+    bst.for_each_in_range(33, 62, [](int x) { std::cout << x << " "; });
+    std::cout << std::endl;     // 35 40 45 50 60
+
+    /// 删除有两个子节点的元素后，父指针仍然正确；指向其它元素的迭代器不受影响
+    auto it65 = bst.lower_bound(65);
+    bst.remove(30);
+    bst.remove(50);
+    bst.insert(55);
+    BinarySearchTree<int> copy = bst;
+    for (int x : copy)
+        std::cout << x << " ";
+    std::cout << *it65 << " " << *--it65 << std::endl; // 20 35 40 45 55 60 65 70 80 65 60
+    try {
+        ++copy.end();
+    } catch (const IteratorOutOfBoundsException &) {
+        std::cout << "++end() rejected" << std::endl;
+    }
+    try {
+        --copy.begin();
+    } catch (const IteratorOutOfBoundsException &) {
+        std::cout << "--begin() rejected" << std::endl;
+    }
+    try {
+        *BinarySearchTree<int>::const_iterator{};
+    } catch (const IteratorUninitializedException &) {
+        std::cout << "uninitialized iterator rejected" << std::endl;
+    }
+
+    /// 在 10^7 个元素的链上数出一个区间，只访问区间附近的节点
+    Chain chain(10000000, false);
+    long long sum = 0;
+    chain.for_each_in_range(9999990, 20000000, [&sum](int x) { sum += x; });
+    chain.rebuild();
+    int count = 0;
+    chain.for_each_in_range(1000, 1999, [&count](int) { count++; });
+    std::cout << sum << " " << count << " " << std::distance(chain.begin(), chain.end())
+              << std::endl;     // 109999945 1000 10000000
+}
+
 int main() {
     testBinarySearchTree();
+    testDegenerateTree();
+    testBulkLoad();
+    testIterators();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,290 @@
+#ifndef __INTRUSIVE_LINKED_LIST_MARK__
+#define __INTRUSIVE_LINKED_LIST_MARK__
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+/// 侵入式单链表的挂钩，想放进 IntrusiveSingleLinkedList 的类型公有继承它。
+/// 要同时挂在几张表上时用不同的 Tag 继承几个挂钩
+template <typename Tag = void>
+struct SListHook
+{
+    SListHook *next = nullptr;  // 不在表中时为 nullptr
+
+    SListHook() = default;
+    /// 拷贝出来的对象不在任何表中，赋值也不改变两边所在的表
+    SListHook(const SListHook &) {}
+    SListHook &operator=(const SListHook &) { return *this; }
+    bool is_linked() const { return next != nullptr; }
+};
+
+/// 侵入式单链表。表只把元素身上的 SListHook 串起来，元素由调用者自己创建和销毁，
+/// 插入和删除不分配也不释放内存。表析构或 emptyList 时只把元素摘下来，不会析构它们。
+///
+/// 表是一个以表内哨兵收尾的环：最后一个元素的 next 指向哨兵，所以挂在表上的元素 next 永远不为空，
+/// 哨兵本身就是第一个元素之前的位置。单链表找不到前一个元素，所以 O(1) 的删除是 remove_after；
+/// 只给出元素本身的 remove 要从头找前一个元素，是 O(n) 的。
+template <typename T, typename Tag = void>
+class IntrusiveSingleLinkedList
+{
+    using Hook = SListHook<Tag>;
+    static_assert(std::is_base_of<Hook, T>::value, "T must derive from SListHook<Tag>");
+
+private:
+    Hook head;                  // 哨兵，head.next 是第一个元素，空表时指向自己
+    Hook *tail = &head;         // 最后一个元素，空表时为哨兵
+    int size = 0;
+    static T &_elem(Hook *h) { return static_cast<T &>(*h); }
+    /// 把 x 挂在 pos 后面
+    void _linkAfter(Hook *pos, T &x);
+    /// 摘下 pos 后面的元素
+    void _unlinkAfter(Hook *pos);
+    /// 接管 _l 的全部元素，调用前当前表必须是空的
+    void _take(IntrusiveSingleLinkedList<T, Tag> &_l);
+public:
+    /// 只读的前向迭代器
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() {}
+        const T &operator*() const { return static_cast<const T &>(*current); }
+        const T *operator->() const { return &**this; }
+        const_iterator &operator++() { current = current->next; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+        bool operator==(const const_iterator &rhs) const { return current == rhs.current; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+    protected:
+        Hook *current = nullptr;
+        const_iterator(Hook *p) : current{p} {}
+
+        friend class IntrusiveSingleLinkedList<T, Tag>;
+    };
+
+    /// 可以修改元素的前向迭代器
+    class iterator : public const_iterator
+    {
+    public:
+        using pointer = T *;
+        using reference = T &;
+
+        iterator() {}
+        T &operator*() const { return static_cast<T &>(*this->current); }
+        T *operator->() const { return &**this; }
+        iterator &operator++() { this->current = this->current->next; return *this; }
+        iterator operator++(int) { iterator old = *this; ++(*this); return old; }
+
+    protected:
+        iterator(Hook *p) : const_iterator{p} {}
+
+        friend class IntrusiveSingleLinkedList<T, Tag>;
+    };
+
+    iterator begin() { return {head.next}; }
+    iterator end() { return {&head}; }
+    const_iterator begin() const { return {head.next}; }
+    const_iterator end() const { return {const_cast<Hook *>(&head)}; }
+
+    IntrusiveSingleLinkedList() { head.next = &head; }
+    /// 元素不属于表，挂钩也不能同时在两张表中，所以不能拷贝，只能移动
+    IntrusiveSingleLinkedList(const IntrusiveSingleLinkedList<T, Tag> &_l) = delete;
+    IntrusiveSingleLinkedList<T, Tag>& operator=(const IntrusiveSingleLinkedList<T, Tag> &_l) = delete;
+    IntrusiveSingleLinkedList(IntrusiveSingleLinkedList<T, Tag> &&_l) noexcept;
+    IntrusiveSingleLinkedList<T, Tag>& operator=(IntrusiveSingleLinkedList<T, Tag> &&_l) noexcept;
+    ~IntrusiveSingleLinkedList();
+
+    bool isEmpty() const;
+    int getSize() const;
+    /// 把所有元素摘下来，元素本身不受影响
+    void emptyList();
+    /// 表头、表尾的元素，空表时抛出 std::out_of_range
+    T &front();
+    T &back();
+
+    /// 插入的元素不能已经在某张表中，否则抛出 std::invalid_argument
+    void push_front(T &x);
+    void push_back(T &x);
+    /// 把 x 挂在 pos 后面，pos 必须在当前表中，O(1)
+    void insert_after(T &pos, T &x);
+    /// 摘下表头，空表时什么也不做
+    void pop_front();
+    /// 摘下 pos 后面的元素，O(1)。pos 是最后一个元素时什么也不做
+    void remove_after(T &pos);
+    /// 摘下 x，要从头找它前面的元素，O(n)。x 不在当前表中时返回 false
+    bool remove(T &x);
+
+    void printList() const;
+};
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::_linkAfter(Hook *pos, T &x)
+{
+    Hook *h = &x;
+    if (h->is_linked())
+        throw std::invalid_argument("Element is already linked into a list");
+    h->next = pos->next;
+    pos->next = h;
+    if (tail == pos)
+        tail = h;
+    ++size;
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::_unlinkAfter(Hook *pos)
+{
+    Hook *h = pos->next;
+    if (h == &head)
+        return;
+    pos->next = h->next;
+    if (tail == h)
+        tail = pos;
+    h->next = nullptr;
+    --size;
+}
+
+/// 元素不动，只让最后一个元素改为指向自己的哨兵
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::_take(IntrusiveSingleLinkedList<T, Tag> &_l)
+{
+    if (_l.size == 0)
+        return;
+    head.next = _l.head.next;
+    tail = _l.tail;
+    tail->next = &head;
+    size = _l.size;
+    _l.head.next = &_l.head;
+    _l.tail = &_l.head;
+    _l.size = 0;
+}
+
+template <typename T, typename Tag>
+IntrusiveSingleLinkedList<T, Tag>::IntrusiveSingleLinkedList(IntrusiveSingleLinkedList<T, Tag> &&_l) noexcept
+{
+    head.next = &head;
+    _take(_l);
+}
+
+template <typename T, typename Tag>
+IntrusiveSingleLinkedList<T, Tag>& IntrusiveSingleLinkedList<T, Tag>::operator=(IntrusiveSingleLinkedList<T, Tag> &&_l) noexcept
+{
+    if (this == &_l)
+        return *this;
+    emptyList();
+    _take(_l);
+    return *this;
+}
+
+template <typename T, typename Tag>
+IntrusiveSingleLinkedList<T, Tag>::~IntrusiveSingleLinkedList()
+{
+    emptyList();
+}
+
+template <typename T, typename Tag>
+bool IntrusiveSingleLinkedList<T, Tag>::isEmpty() const
+{
+    return size == 0;
+}
+
+template <typename T, typename Tag>
+int IntrusiveSingleLinkedList<T, Tag>::getSize() const
+{
+    return size;
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::emptyList()
+{
+    Hook *p = head.next;
+    while (p != &head)
+    {
+        Hook *t = p;
+        p = p->next;
+        t->next = nullptr;
+    }
+    head.next = &head;
+    tail = &head;
+    size = 0;
+}
+
+template <typename T, typename Tag>
+T &IntrusiveSingleLinkedList<T, Tag>::front()
+{
+    if (size == 0)
+        throw std::out_of_range("Attempting to access front of an empty list");
+    return _elem(head.next);
+}
+
+template <typename T, typename Tag>
+T &IntrusiveSingleLinkedList<T, Tag>::back()
+{
+    if (size == 0)
+        throw std::out_of_range("Attempting to access back of an empty list");
+    return _elem(tail);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::push_front(T &x)
+{
+    _linkAfter(&head, x);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::push_back(T &x)
+{
+    _linkAfter(tail, x);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::insert_after(T &pos, T &x)
+{
+    _linkAfter(&pos, x);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::pop_front()
+{
+    _unlinkAfter(&head);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::remove_after(T &pos)
+{
+    _unlinkAfter(&pos);
+}
+
+template <typename T, typename Tag>
+bool IntrusiveSingleLinkedList<T, Tag>::remove(T &x)
+{
+    Hook *h = &x;
+    if (!h->is_linked())
+        return false;
+    for (Hook *p = &head; p->next != &head; p = p->next)
+        if (p->next == h)
+        {
+            _unlinkAfter(p);
+            return true;
+        }
+    return false;
+}
+
+template <typename T, typename Tag>
+void IntrusiveSingleLinkedList<T, Tag>::printList() const
+{
+    for (const T &x : *this)
+        std::cout << x << "\t";
+    std::cout << std::endl;
+}
+
+#else
+// DO NOTHING.
+#endif
@@ -1,6 +1,17 @@
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include "../List/OutputBuffer.h"
+#include "../List/NodePool.h"
 
+/// 单链表。表里只有一个 currentPos，find、insert、remove 都会移动它，所以这一套接口
+/// 同一时刻只能有一个使用者。需要多个位置时用 Cursor：每个使用者各拿一个，互不干扰。
+///
+/// 所有 const 成员函数 (包括接受 Cursor 的 find) 都不修改任何状态，所以只要没有线程在修改这张表，
+/// 任意多个线程可以同时调用它们遍历和查找，不需要加锁。
 template <typename T>
 class SingleLinkedList
 {
@@ -10,16 +21,112 @@ private:
     private:
         T data;
         Node *next = nullptr;
-        Node(T _val){data = _val;}
+        /// data 直接用参数构造，不再先默认构造再赋值
+        template <typename... Args>
+        Node(Args &&..._args) : data(std::forward<Args>(_args)...) {}
 
         friend class SingleLinkedList<T>;
+        friend class NodePool<Node>;    // 内存池的回收链借用 next 指针
     };
     Node* head = nullptr;
+    /// 最后一个节点。有了它在表尾插入就不必从头走到尾，也不必借用 currentPos
+    Node* tail = nullptr;
     int size = 0;
     Node* currentPos = nullptr;
+    /// 节点从内存池中分配，拷贝时可以按元素个数一次预留好，整张表析构时整体释放
+    NodePool<Node> pool;
+    template <typename... Args>
+    Node *_newNode(Args &&..._args);
+    void _deleteNode(Node *p);
     void _emptyList();
     void _copy(const SingleLinkedList<T> &_l);
+    /// 把从 p 开始的节点依次拷贝一份，接在 last 后面 (last 为空则作为表头)，返回最后一个新节点。
+    /// 每接上一个就更新 tail 和 size，中途抛出异常时表仍然是完整的
+    Node *_append(Node *last, const Node *p);
 public:
+    /// 只读的前向迭代器，单链表只能向后走
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() {}
+        const T &operator*() const { return current->data; }
+        const T *operator->() const { return &current->data; }
+        const_iterator &operator++() { current = current->next; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+        bool operator==(const const_iterator &rhs) const { return current == rhs.current; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+    protected:
+        Node *current = nullptr;
+        const_iterator(Node *p) : current{p} {}
+
+        friend class SingleLinkedList<T>;
+    };
+
+    /// 可以修改元素的前向迭代器
+    class iterator : public const_iterator
+    {
+    public:
+        using pointer = T *;
+        using reference = T &;
+
+        iterator() {}
+        T &operator*() const { return this->current->data; }
+        T *operator->() const { return &this->current->data; }
+        iterator &operator++() { this->current = this->current->next; return *this; }
+        iterator operator++(int) { iterator old = *this; ++(*this); return old; }
+
+    protected:
+        iterator(Node *p) : const_iterator{p} {}
+
+        friend class SingleLinkedList<T>;
+    };
+
+    /// 独立于 currentPos 的位置，只是一个指针，可以随意拷贝。默认构造的 Cursor 在第一个元素之前，
+    /// 这时 insert_after 在表头插入，remove_after 删除表头。它指向的元素被删除后就失效了
+    class Cursor
+    {
+    public:
+        Cursor() {}
+        /// 是否在第一个元素之前 (不指向任何元素)
+        bool is_before_begin() const { return pos == nullptr; }
+        /// 指向的元素，调用者保证不在第一个元素之前
+        const T &get() const { return pos->data; }
+        /// 移到下一个元素。已经是最后一个元素时返回 false，位置不变
+        bool advance(const SingleLinkedList<T> &_l)
+        {
+            Node *n = pos == nullptr ? _l.head : pos->next;
+            if (n == nullptr)
+                return false;
+            pos = n;
+            return true;
+        }
+        bool operator==(const Cursor &rhs) const { return pos == rhs.pos; }
+        bool operator!=(const Cursor &rhs) const { return pos != rhs.pos; }
+
+    private:
+        Node *pos = nullptr;
+        Cursor(Node *p) : pos{p} {}
+
+        friend class SingleLinkedList<T>;
+    };
+
+    /// 第一个元素之前的位置
+    Cursor before_begin() const { return {}; }
+    /// currentPos 所在的位置
+    Cursor current() const { return {currentPos}; }
+
+    iterator begin() { return {head}; }
+    iterator end() { return {nullptr}; }
+    const_iterator begin() const { return {head}; }
+    const_iterator end() const { return {nullptr}; }
+
     /// 返回当前位置的值
     T getCurrentVal() const;
     /// 设置当前位置的值
@@ -34,16 +141,57 @@ public:
     ~SingleLinkedList(); 
     SingleLinkedList(std::initializer_list<T> _l);
     void printList() const;
+    /// 按照 fmt 把所有元素写到 out 的缓冲区中，用法见 List::write_to
+    void write_to(OutputBuffer &out, const WriteFormat &fmt = {}) const;
+    /// 按照 fmt 把所有元素写到流 os 中
+    void write_to(std::ostream &os, const WriteFormat &fmt = {}) const;
     SingleLinkedList(const SingleLinkedList<T> &_l);
     SingleLinkedList<T>& operator=(const SingleLinkedList<T> &_l);
+    /// 移动只是接管节点和内存池，_l 之后是一张空表
+    SingleLinkedList(SingleLinkedList<T> &&_l) noexcept;
+    SingleLinkedList<T>& operator=(SingleLinkedList<T> &&_l) noexcept;
 
     /// 在 currentPos 后面插入一个元素，数据为 _val
-    void insert(T _val); 
+    void insert(const T &_val) { emplace(_val); }
+    void insert(T &&_val) { emplace(std::move(_val)); }
+    /// 用 _args 在 currentPos 后面直接构造一个元素，其余同 insert
+    template <typename... Args>
+    void emplace(Args &&..._args);
     /// 如果找到，返回 ture, currentPos 停留在第一个 _val 的位置。
     /// 否则返回 false, currentPos 不动。
     bool find(const T &_val);  
     /// 删除 currentPos 后面的元素
     void remove();                                        
+
+    /// 如果找到，返回 true, _c 停留在第一个 _val 的位置；否则返回 false, _c 不动。
+    /// 不修改 currentPos，可以在多个线程中同时调用
+    bool find(const T &_val, Cursor &_c) const;
+    /// 在 _c 后面插入一个元素，_c 移到新元素上。currentPos 不动 (空表时除外，同 push_front)
+    void insert_after(Cursor &_c, const T &_val) { emplace_after(_c, _val); }
+    void insert_after(Cursor &_c, T &&_val) { emplace_after(_c, std::move(_val)); }
+    template <typename... Args>
+    void emplace_after(Cursor &_c, Args &&..._args);
+    /// 删除 _c 后面的元素，_c 不动。如果 currentPos 正指向被删的元素，它退到 _c 的位置
+    /// (_c 在第一个元素之前时退到新的表头)
+    void remove_after(Cursor &_c);
+
+    /// 在表头插入一个元素。空表时 currentPos 指向它
+    void push_front(const T &_val) { emplace_front(_val); }
+    void push_front(T &&_val) { emplace_front(std::move(_val)); }
+    template <typename... Args>
+    void emplace_front(Args &&..._args);
+    /// 在表尾插入一个元素，借助 tail 是 O(1) 的。空表时 currentPos 指向它
+    void push_back(const T &_val) { emplace_back(_val); }
+    void push_back(T &&_val) { emplace_back(std::move(_val)); }
+    template <typename... Args>
+    void emplace_back(Args &&..._args);
+    /// 删除表头的元素。如果 currentPos 正指向它，currentPos 移到新的表头
+    void pop_front();
+    /// 表头和表尾的元素，空表时抛出 std::out_of_range
+    T &front();
+    const T &front() const;
+    T &back();
+    const T &back() const;
 };
 
 template<typename T>
@@ -71,33 +219,50 @@ int SingleLinkedList<T>::getSize() const
 template <typename T>
 SingleLinkedList<T>::SingleLinkedList(std::initializer_list<T> _l)
 {
+    pool.reserve(_l.size());
     for (auto i = _l.begin(); i != _l.end(); ++i)
+        push_back(*i);
+    currentPos = tail;
+}
+
+template <typename T>
+template <typename... Args>
+typename SingleLinkedList<T>::Node *SingleLinkedList<T>::_newNode(Args &&..._args)
+{
+    Node *p = pool.allocate();
+    try
     {
-        Node* newNode = new Node(*i);
-        if (head == nullptr)
-        {
-            head = newNode;
-            currentPos = head;
-        }
-        else
-        {
-            currentPos->next = newNode;
-            currentPos = newNode;
-        }
-        ++size;
+        return new (p) Node(std::forward<Args>(_args)...);
+    }
+    catch (...)
+    {
+        pool.deallocate(p);
+        throw;
     }
 }
 
+template <typename T>
+void SingleLinkedList<T>::_deleteNode(Node *p)
+{
+    p->~Node();
+    pool.deallocate(p);
+}
+
 template <typename T>
 void SingleLinkedList<T>::_emptyList()
 {
-    Node* p = head;
-    while (p != nullptr)
+    /// 元素不需要析构时连遍历都省了，节点的空间随内存池一次释放
+    if constexpr (!std::is_trivially_destructible<T>::value)
     {
-        Node* t = p;
-        p = p->next; 
-        delete t;
+        Node* p = head;
+        while (p != nullptr)
+        {
+            Node* t = p;
+            p = p->next; 
+            t->~Node();
+        }
     }
+    pool.release();
 }
 
 template <typename T>
@@ -112,6 +277,21 @@ void SingleLinkedList<T>::printList() const
     std::cout << std::endl;    
 }
 
+template <typename T>
+void SingleLinkedList<T>::write_to(OutputBuffer &out, const WriteFormat &fmt) const
+{
+    for (Node *p = head; p != nullptr; p = p->next)
+        out.element(p->data, fmt, p == head);
+    out.finish(fmt);
+}
+
+template <typename T>
+void SingleLinkedList<T>::write_to(std::ostream &os, const WriteFormat &fmt) const
+{
+    OutputBuffer out(os);
+    write_to(out, fmt);
+}
+
 template <typename T>
 SingleLinkedList<T>::~SingleLinkedList()
 {
@@ -121,7 +301,41 @@ SingleLinkedList<T>::~SingleLinkedList()
 template<typename T>
 SingleLinkedList<T>::SingleLinkedList(const SingleLinkedList<T> &_l)
 {
-    _copy(_l);
+    /// 构造函数抛出异常时不会调用析构函数，已经拷好的元素要自己析构
+    try
+    {
+        _copy(_l);
+    }
+    catch (...)
+    {
+        _emptyList();
+        throw;
+    }
+}
+
+template<typename T>
+SingleLinkedList<T>::SingleLinkedList(SingleLinkedList<T> &&_l) noexcept
+    : head{_l.head}, tail{_l.tail}, size{_l.size}, currentPos{_l.currentPos}, pool{std::move(_l.pool)}
+{
+    _l.head = _l.tail = _l.currentPos = nullptr;
+    _l.size = 0;
+}
+
+/// 先释放自己的节点，再接管 _l 的。内存池交换之后 _l 拿到的是一个空池
+template<typename T>
+SingleLinkedList<T>& SingleLinkedList<T>::operator=(SingleLinkedList<T> &&_l) noexcept
+{
+    if (this == &_l)
+        return *this;
+    emptyList();
+    pool = std::move(_l.pool);
+    head = _l.head;
+    tail = _l.tail;
+    size = _l.size;
+    currentPos = _l.currentPos;
+    _l.head = _l.tail = _l.currentPos = nullptr;
+    _l.size = 0;
+    return *this;
 }
 
 template<typename T>
@@ -129,40 +343,74 @@ void SingleLinkedList<T>::emptyList()
 {
     _emptyList();
     head = nullptr;
+    tail = nullptr;
     currentPos = nullptr;
     size = 0;
 }
 
+/// 不再先清空再重新拷贝，而是直接给已有的节点赋值，只删掉多出来的节点，或者补上不够的节点。
+/// 和拷贝构造一样，赋值之后 currentPos 停在最后一个元素上。
 template<typename T>
 SingleLinkedList<T>& SingleLinkedList<T>::operator=(const SingleLinkedList<T> &_l)
 {
     if (this == &_l)
         return *this;
-    emptyList();
-    _copy(_l);
+    Node *p = head;
+    const Node *q = _l.head;
+    Node *last = nullptr;
+    for (; p != nullptr && q != nullptr; p = p->next, q = q->next)
+    {
+        p->data = q->data;
+        last = p;
+    }
+    if (p != nullptr)
+    {
+        if (last == nullptr)
+            head = nullptr;
+        else
+            last->next = nullptr;
+        while (p != nullptr)
+        {
+            Node *t = p;
+            p = p->next;
+            _deleteNode(t);
+            --size;
+        }
+    }
+    else if (q != nullptr)
+    {
+        pool.reserve(_l.size - size);
+        last = _append(last, q);
+    }
+    tail = last;
+    currentPos = last;
     return *this;
 }
 
+/// 元素个数事先知道，所以先在内存池中一次预留好所有节点，新节点在同一块内存里连续排列，
+/// 然后一趟拷贝、链接。元素可平凡拷贝时每个元素的拷贝就是一次 memcpy。
 template <typename T>
 void SingleLinkedList<T>::_copy(const SingleLinkedList<T> &_l)
 {
-    Node *p = _l.head;
-    while (p != nullptr)
+    pool.reserve(_l.size);
+    currentPos = tail = _append(nullptr, _l.head);
+}
+
+template <typename T>
+typename SingleLinkedList<T>::Node *SingleLinkedList<T>::_append(Node *last, const Node *p)
+{
+    for (; p != nullptr; p = p->next)
     {
-        Node* newNode = new Node(p->data);
-        if (head == nullptr)
-        {
+        Node *newNode = _newNode(p->data);
+        if (last == nullptr)
             head = newNode;
-            currentPos = head;
-        }
         else
-        {
-            currentPos->next = newNode;
-            currentPos = newNode;
-        }
+            last->next = newNode;
+        last = newNode;
+        tail = newNode;
         ++size;
-        p = p->next;
     }
+    return last;
 }
 
 
@@ -197,16 +445,19 @@ bool SingleLinkedList<T>:: isEmpty() const
 }
 
 template <typename T>
-void SingleLinkedList<T>:: insert(T _val)
+template <typename... Args>
+void SingleLinkedList<T>::emplace(Args &&..._args)
 {
-    Node *p = new Node(_val);
+    Node *p = _newNode(std::forward<Args>(_args)...);
     if(head == nullptr)
     {
-        head = p;
+        head = tail = p;
         currentPos = head;
     } else {
         p->next = currentPos->next;
         currentPos->next = p;
+        if (currentPos == tail)
+            tail = p;
         currentPos = p;     // 更新currentPos为插入元素的位置
     }
     ++size;
@@ -219,16 +470,142 @@ void SingleLinkedList<T>:: remove()
     {
         if(size == 1)
         {
-            delete head;
-            head = nullptr;
+            _deleteNode(head);
+            head = tail = nullptr;
             currentPos = nullptr;
             size = 0;
         } else if(currentPos->next != nullptr)
         {
             Node *p = (currentPos->next)->next;
-            delete currentPos->next;
+            if (currentPos->next == tail)
+                tail = currentPos;
+            _deleteNode(currentPos->next);
             currentPos->next = p;   // remove操作不更新currentPos
             --size;
         }
     }
-}
\ No newline at end of file
+}
+
+template <typename T>
+template <typename... Args>
+void SingleLinkedList<T>::emplace_front(Args &&..._args)
+{
+    Node *p = _newNode(std::forward<Args>(_args)...);
+    p->next = head;
+    head = p;
+    if (tail == nullptr)
+        tail = currentPos = p;
+    ++size;
+}
+
+template <typename T>
+template <typename... Args>
+void SingleLinkedList<T>::emplace_back(Args &&..._args)
+{
+    Node *p = _newNode(std::forward<Args>(_args)...);
+    if (tail == nullptr)
+        head = currentPos = p;
+    else
+        tail->next = p;
+    tail = p;
+    ++size;
+}
+
+template <typename T>
+void SingleLinkedList<T>::pop_front()
+{
+    if (head == nullptr)
+        throw std::out_of_range("Attempting to pop from an empty list");
+    Node *p = head;
+    head = head->next;
+    if (head == nullptr)
+        tail = nullptr;
+    if (currentPos == p)
+        currentPos = head;
+    _deleteNode(p);
+    --size;
+}
+
+template <typename T>
+T &SingleLinkedList<T>::front()
+{
+    if (head == nullptr)
+        throw std::out_of_range("Attempting to access front of an empty list");
+    return head->data;
+}
+
+template <typename T>
+const T &SingleLinkedList<T>::front() const
+{
+    if (head == nullptr)
+        throw std::out_of_range("Attempting to access front of an empty list");
+    return head->data;
+}
+
+template <typename T>
+T &SingleLinkedList<T>::back()
+{
+    if (tail == nullptr)
+        throw std::out_of_range("Attempting to access back of an empty list");
+    return tail->data;
+}
+
+template <typename T>
+const T &SingleLinkedList<T>::back() const
+{
+    if (tail == nullptr)
+        throw std::out_of_range("Attempting to access back of an empty list");
+    return tail->data;
+}
+
+template <typename T>
+bool SingleLinkedList<T>::find(const T &_val, Cursor &_c) const
+{
+    for (Node *p = head; p != nullptr; p = p->next)
+        if (p->data == _val)
+        {
+            _c.pos = p;
+            return true;
+        }
+    return false;
+}
+
+template <typename T>
+template <typename... Args>
+void SingleLinkedList<T>::emplace_after(Cursor &_c, Args &&..._args)
+{
+    if (_c.pos == nullptr)
+    {
+        emplace_front(std::forward<Args>(_args)...);
+        _c.pos = head;
+        return;
+    }
+    Node *p = _newNode(std::forward<Args>(_args)...);
+    p->next = _c.pos->next;
+    _c.pos->next = p;
+    if (_c.pos == tail)
+        tail = p;
+    _c.pos = p;
+    ++size;
+}
+
+template <typename T>
+void SingleLinkedList<T>::remove_after(Cursor &_c)
+{
+    if (_c.pos == nullptr)
+    {
+        if (head != nullptr)
+            pop_front();
+        return;
+    }
+    Node *p = _c.pos->next;
+    if (p == nullptr)
+        return;
+    _c.pos->next = p->next;
+    if (p == tail)
+        tail = _c.pos;
+    if (currentPos == p)
+        currentPos = _c.pos;
+    _deleteNode(p);
+    --size;
+}
@@ -0,0 +1,333 @@
+#ifndef __PACKED_LINKED_LIST_MARK__
+#define __PACKED_LINKED_LIST_MARK__
+
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "../List/SimdFind.h"
+
+/// 接口和 SingleLinkedList 的 currentPos 那一套相同的单链表，专门给算术类型的元素用。
+/// 每个节点 (块) 里连续存放最多 N 个元素，find 对每个块整块用 SimdFind 做向量比较，
+/// 而不是每比较一个元素就追一次 next 指针。
+///
+/// currentPos 由所在的块和块内下标组成。插入和删除会在块内搬动元素，块满了对半分裂，
+/// 删除后块太空就和后一个块合并，这些都会相应地调整 currentPos，它始终指向同一个元素。
+template <typename T, int N = 64>
+class PackedSingleLinkedList
+{
+    static_assert(std::is_arithmetic<T>::value, "PackedSingleLinkedList only stores arithmetic types");
+    static_assert(N >= 2, "a chunk must hold at least two elements");
+
+private:
+    class Chunk
+    {
+    private:
+        T data[N];
+        int count = 0;
+        Chunk *next = nullptr;
+
+        friend class PackedSingleLinkedList<T, N>;
+    };
+    Chunk* head = nullptr;
+    Chunk* tail = nullptr;
+    int size = 0;
+    Chunk* currentChunk = nullptr;  // currentPos 所在的块
+    int currentIndex = 0;           // currentPos 在块内的下标
+    void _emptyList();
+    void _copy(const PackedSingleLinkedList<T, N> &_l);
+    /// 在块 c 后面新建一个空块
+    Chunk *_newChunkAfter(Chunk *c);
+    /// c 元素太少时，把后一个块并进来
+    void _mergeNext(Chunk *c);
+public:
+    /// 返回当前位置的值
+    T getCurrentVal() const;
+    /// 设置当前位置的值
+    void setCurrentVal(const T &_val);
+    /// 如果链表为空，返回 true；否则返回 false
+    bool isEmpty() const;
+
+    int getSize() const;
+    void emptyList();
+    PackedSingleLinkedList(){};
+    ~PackedSingleLinkedList();
+    PackedSingleLinkedList(std::initializer_list<T> _l);
+    PackedSingleLinkedList(const PackedSingleLinkedList<T, N> &_l);
+    PackedSingleLinkedList<T, N>& operator=(const PackedSingleLinkedList<T, N> &_l);
+    void printList() const;
+
+    /// 在 currentPos 后面插入一个元素，数据为 _val
+    void insert(const T &_val);
+    /// 如果找到，返回 ture, currentPos 停留在第一个 _val 的位置。
+    /// 否则返回 false, currentPos 不动。
+    bool find(const T &_val);
+    /// 删除 currentPos 后面的元素
+    void remove();
+    /// 在表尾插入一个元素。空表时 currentPos 指向它
+    void push_back(const T &_val);
+};
+
+template <typename T, int N>
+bool PackedSingleLinkedList<T, N>::find(const T &_val)
+{
+    /// 指令集只检测一次，不要在每个块里重新判断
+    const SimdFind::Level level = SimdFind::level();
+    for (Chunk *c = head; c != nullptr; c = c->next)
+    {
+        const T *p = SimdFind::find(c->data, c->data + c->count, _val, level);
+        if (p != c->data + c->count)
+        {
+            currentChunk = c;
+            currentIndex = p - c->data;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, int N>
+int PackedSingleLinkedList<T, N>::getSize() const
+{
+    return size;
+}
+
+template <typename T, int N>
+PackedSingleLinkedList<T, N>::PackedSingleLinkedList(std::initializer_list<T> _l)
+{
+    for (auto i = _l.begin(); i != _l.end(); ++i)
+        push_back(*i);
+    if (tail != nullptr)
+    {
+        currentChunk = tail;
+        currentIndex = tail->count - 1;
+    }
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::_emptyList()
+{
+    Chunk* c = head;
+    while (c != nullptr)
+    {
+        Chunk* t = c;
+        c = c->next;
+        delete t;
+    }
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::printList() const
+{
+    for (Chunk *c = head; c != nullptr; c = c->next)
+        for (int i = 0; i < c->count; ++i)
+            std::cout << c->data[i] << "\t";
+    std::cout << std::endl;
+}
+
+template <typename T, int N>
+PackedSingleLinkedList<T, N>::~PackedSingleLinkedList()
+{
+    _emptyList();
+}
+
+template <typename T, int N>
+PackedSingleLinkedList<T, N>::PackedSingleLinkedList(const PackedSingleLinkedList<T, N> &_l)
+{
+    _copy(_l);
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::emptyList()
+{
+    _emptyList();
+    head = tail = currentChunk = nullptr;
+    currentIndex = 0;
+    size = 0;
+}
+
+template <typename T, int N>
+PackedSingleLinkedList<T, N>& PackedSingleLinkedList<T, N>::operator=(const PackedSingleLinkedList<T, N> &_l)
+{
+    if (this == &_l)
+        return *this;
+    emptyList();
+    _copy(_l);
+    return *this;
+}
+
+/// 整块拷贝，块的划分和原表相同。和 SingleLinkedList 一样，拷贝之后 currentPos 停在最后一个元素上
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::_copy(const PackedSingleLinkedList<T, N> &_l)
+{
+    for (Chunk *c = _l.head; c != nullptr; c = c->next)
+    {
+        Chunk *n = _newChunkAfter(tail);
+        for (int i = 0; i < c->count; ++i)
+            n->data[i] = c->data[i];
+        n->count = c->count;
+        size += c->count;
+    }
+    if (tail != nullptr)
+    {
+        currentChunk = tail;
+        currentIndex = tail->count - 1;
+    }
+}
+
+template <typename T, int N>
+typename PackedSingleLinkedList<T, N>::Chunk *PackedSingleLinkedList<T, N>::_newChunkAfter(Chunk *c)
+{
+    Chunk *n = new Chunk;
+    if (c == nullptr)
+    {
+        n->next = head;
+        head = n;
+    }
+    else
+    {
+        n->next = c->next;
+        c->next = n;
+    }
+    if (tail == c)
+        tail = n;
+    return n;
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::_mergeNext(Chunk *c)
+{
+    Chunk *n = c->next;
+    if (n == nullptr || c->count >= N / 2 || c->count + n->count > N)
+        return;
+    for (int i = 0; i < n->count; ++i)
+        c->data[c->count + i] = n->data[i];
+    c->count += n->count;
+    c->next = n->next;
+    if (tail == n)
+        tail = c;
+    delete n;
+}
+
+template <typename T, int N>
+T PackedSingleLinkedList<T, N>::getCurrentVal() const
+{
+    if(currentChunk != nullptr)
+        return currentChunk->data[currentIndex];
+    else {
+        std::cout << "Empty current position! Can't get value!" << std::endl;
+        throw std::runtime_error("Current position is nullptr");
+    }
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::setCurrentVal(const T &_val)
+{
+    if(currentChunk != nullptr)
+        currentChunk->data[currentIndex] = _val;
+    else {
+        std::cout << "Empty current position! Can't set value!" << std::endl;
+    }
+}
+
+template <typename T, int N>
+bool PackedSingleLinkedList<T, N>::isEmpty() const
+{
+    return head == nullptr;
+}
+
+/// 块满了先对半分裂，currentPos 落在后一半时随之移到新块
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::insert(const T &_val)
+{
+    if (head == nullptr)
+    {
+        push_back(_val);
+        return;
+    }
+    Chunk *c = currentChunk;
+    int i = currentIndex + 1;
+    if (c->count == N)
+    {
+        const int half = N / 2;
+        Chunk *right = _newChunkAfter(c);
+        for (int j = half; j < N; ++j)
+            right->data[j - half] = c->data[j];
+        right->count = N - half;
+        c->count = half;
+        if (i > half)
+        {
+            c = right;
+            i -= half;
+        }
+    }
+    for (int j = c->count; j > i; --j)
+        c->data[j] = c->data[j - 1];
+    c->data[i] = _val;
+    ++c->count;
+    ++size;
+    currentChunk = c;   // 更新currentPos为插入元素的位置
+    currentIndex = i;
+}
+
+/// 被删的元素要么在 currentPos 的块里，要么是下一个块的第一个元素。
+/// 删完之后只会把变少的块后面的块并进它，currentPos 所在的块不会被并走，currentPos 不受影响
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::remove()
+{
+    if (head == nullptr)
+        return;
+    if (size == 1)
+    {
+        emptyList();
+        return;
+    }
+    Chunk *c = currentChunk;
+    Chunk *shrunk = c;
+    int i = currentIndex + 1;
+    if (i == c->count)
+    {
+        if (c->next == nullptr)
+            return;     // currentPos 是最后一个元素，后面没有可删的
+        Chunk *n = c->next;
+        for (int j = 1; j < n->count; ++j)
+            n->data[j - 1] = n->data[j];
+        shrunk = n;
+        if (--n->count == 0)
+        {
+            c->next = n->next;
+            if (tail == n)
+                tail = c;
+            delete n;
+            shrunk = c;
+        }
+    }
+    else
+    {
+        for (int j = i + 1; j < c->count; ++j)
+            c->data[j - 1] = c->data[j];
+        --c->count;
+    }
+    --size;
+    _mergeNext(c);
+    if (shrunk != c && c->next == shrunk)
+        _mergeNext(shrunk);
+}
+
+template <typename T, int N>
+void PackedSingleLinkedList<T, N>::push_back(const T &_val)
+{
+    if (tail == nullptr || tail->count == N)
+        _newChunkAfter(tail);
+    tail->data[tail->count++] = _val;
+    if (currentChunk == nullptr)
+    {
+        currentChunk = head;
+        currentIndex = 0;
+    }
+    ++size;
+}
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,284 @@
+#ifndef __PERSISTENT_LIST_MARK__
+#define __PERSISTENT_LIST_MARK__
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "../List/OutputBuffer.h"
+
+/// 持久化 (不可变、结构共享) 的单链表。节点一旦挂上就再也不会被修改，
+/// push_front 只是新建一个指向原表头的节点，pop_front 只是让表头后移一步，
+/// 所以一个 PersistentList 对象只是某个版本的表头句柄，拷贝它 (做快照) 是 O(1) 的，
+/// 新旧版本共享后面所有的节点。
+///
+/// 节点带引用计数，最后一个引用它的版本消失时才释放。引用计数是原子的，
+/// 所以不同的 PersistentList 对象可以放在不同的线程中随意读、修改、拷贝和析构，不需要加锁；
+/// 和 std::shared_ptr 一样，同一个 PersistentList 对象被多个线程同时修改时仍需要同步。
+template <typename T>
+class PersistentList
+{
+private:
+    class Node
+    {
+    private:
+        T data;
+        const Node *next;
+        mutable std::atomic<int> refs{1};  // 有几个版本的表头或节点指向它
+        template <typename... Args>
+        Node(const Node *_next, Args &&..._args) : data(std::forward<Args>(_args)...), next{_next} {}
+
+        friend class PersistentList<T>;
+    };
+    const Node* head = nullptr;
+    int size = 0;
+    static const Node *_retain(const Node *p);
+    /// 放弃对 p 的引用。引用计数归零的节点被释放，接着放弃它对下一个节点的引用，
+    /// 用循环而不是递归，长表析构时不会爆栈
+    static void _release(const Node *p);
+public:
+    /// 只读的前向迭代器
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() {}
+        const T &operator*() const { return current->data; }
+        const T *operator->() const { return &current->data; }
+        const_iterator &operator++() { current = current->next; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+        bool operator==(const const_iterator &rhs) const { return current == rhs.current; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+    private:
+        const Node *current = nullptr;
+        const_iterator(const Node *p) : current{p} {}
+
+        friend class PersistentList<T>;
+    };
+    using iterator = const_iterator;
+
+    const_iterator begin() const { return {head}; }
+    const_iterator end() const { return {nullptr}; }
+
+    PersistentList() {}
+    PersistentList(std::initializer_list<T> _l);
+    /// 拷贝就是做快照，只增加表头节点的引用计数，O(1)
+    PersistentList(const PersistentList<T> &_l) noexcept;
+    PersistentList(PersistentList<T> &&_l) noexcept;
+    PersistentList<T>& operator=(const PersistentList<T> &_l) noexcept;
+    PersistentList<T>& operator=(PersistentList<T> &&_l) noexcept;
+    ~PersistentList();
+
+    bool isEmpty() const;
+    int getSize() const;
+    /// 表头的元素，空表时抛出 std::out_of_range
+    const T &front() const;
+    /// 如果找到 _val 返回 true
+    bool contains(const T &_val) const;
+
+    /// 当前句柄指向在表头加上一个元素的新版本，其它版本不受影响，O(1)
+    void push_front(const T &_val) { emplace_front(_val); }
+    void push_front(T &&_val) { emplace_front(std::move(_val)); }
+    template <typename... Args>
+    void emplace_front(Args &&..._args);
+    /// 当前句柄指向去掉表头的版本，它和原来的版本共享后面所有的节点，O(1)。空表时抛出 std::out_of_range
+    void pop_front();
+    /// 去掉表头之后的版本，当前句柄不变
+    PersistentList<T> tail() const;
+    /// 清空当前句柄，其它版本不受影响
+    void emptyList();
+    /// 两个版本是否从表头起就完全共享节点
+    bool sharesWith(const PersistentList<T> &_l) const;
+
+    void printList() const;
+    /// 按照 fmt 把所有元素写到 out 的缓冲区中，用法见 List::write_to
+    void write_to(OutputBuffer &out, const WriteFormat &fmt = {}) const;
+    /// 按照 fmt 把所有元素写到流 os 中
+    void write_to(std::ostream &os, const WriteFormat &fmt = {}) const;
+};
+
+template <typename T>
+const typename PersistentList<T>::Node *PersistentList<T>::_retain(const Node *p)
+{
+    /// 增加引用计数不需要和其它内存操作排序，与 std::shared_ptr 的做法相同
+    if (p != nullptr)
+        p->refs.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+template <typename T>
+void PersistentList<T>::_release(const Node *p)
+{
+    /// acq_rel 保证其它线程对节点的读取都发生在释放之前
+    while (p != nullptr && p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        const Node *next = p->next;
+        delete p;
+        p = next;
+    }
+}
+
+/// 从后往前建表，建好之后第一个元素在表头
+template <typename T>
+PersistentList<T>::PersistentList(std::initializer_list<T> _l)
+{
+    try
+    {
+        for (auto i = _l.end(); i != _l.begin(); )
+            push_front(*--i);
+    }
+    catch (...)
+    {
+        _release(head);
+        throw;
+    }
+}
+
+template <typename T>
+PersistentList<T>::PersistentList(const PersistentList<T> &_l) noexcept
+    : head{_retain(_l.head)}, size{_l.size}
+{
+}
+
+template <typename T>
+PersistentList<T>::PersistentList(PersistentList<T> &&_l) noexcept
+    : head{_l.head}, size{_l.size}
+{
+    _l.head = nullptr;
+    _l.size = 0;
+}
+
+/// 先增加对方的引用再放弃自己的，这样自己给自己赋值也是安全的
+template <typename T>
+PersistentList<T>& PersistentList<T>::operator=(const PersistentList<T> &_l) noexcept
+{
+    const Node *old = head;
+    head = _retain(_l.head);
+    size = _l.size;
+    _release(old);
+    return *this;
+}
+
+template <typename T>
+PersistentList<T>& PersistentList<T>::operator=(PersistentList<T> &&_l) noexcept
+{
+    if (this == &_l)
+        return *this;
+    _release(head);
+    head = _l.head;
+    size = _l.size;
+    _l.head = nullptr;
+    _l.size = 0;
+    return *this;
+}
+
+template <typename T>
+PersistentList<T>::~PersistentList()
+{
+    _release(head);
+}
+
+template <typename T>
+bool PersistentList<T>::isEmpty() const
+{
+    return head == nullptr;
+}
+
+template <typename T>
+int PersistentList<T>::getSize() const
+{
+    return size;
+}
+
+template <typename T>
+const T &PersistentList<T>::front() const
+{
+    if (head == nullptr)
+        throw std::out_of_range("Attempting to access front of an empty list");
+    return head->data;
+}
+
+template <typename T>
+bool PersistentList<T>::contains(const T &_val) const
+{
+    for (const Node *p = head; p != nullptr; p = p->next)
+        if (p->data == _val)
+            return true;
+    return false;
+}
+
+/// 新节点接管当前句柄对原表头的引用，所以原表头的引用计数不变
+template <typename T>
+template <typename... Args>
+void PersistentList<T>::emplace_front(Args &&..._args)
+{
+    head = new Node(head, std::forward<Args>(_args)...);
+    ++size;
+}
+
+template <typename T>
+void PersistentList<T>::pop_front()
+{
+    if (head == nullptr)
+        throw std::out_of_range("Attempting to pop from an empty list");
+    const Node *old = head;
+    head = _retain(head->next);
+    --size;
+    _release(old);
+}
+
+template <typename T>
+PersistentList<T> PersistentList<T>::tail() const
+{
+    PersistentList<T> t(*this);
+    t.pop_front();
+    return t;
+}
+
+template <typename T>
+void PersistentList<T>::emptyList()
+{
+    _release(head);
+    head = nullptr;
+    size = 0;
+}
+
+template <typename T>
+bool PersistentList<T>::sharesWith(const PersistentList<T> &_l) const
+{
+    return head == _l.head;
+}
+
+template <typename T>
+void PersistentList<T>::printList() const
+{
+    for (const Node *p = head; p != nullptr; p = p->next)
+        std::cout << p->data << "\t";
+    std::cout << std::endl;
+}
+
+template <typename T>
+void PersistentList<T>::write_to(OutputBuffer &out, const WriteFormat &fmt) const
+{
+    out.range(begin(), end(), fmt);
+}
+
+template <typename T>
+void PersistentList<T>::write_to(std::ostream &os, const WriteFormat &fmt) const
+{
+    OutputBuffer out(os);
+    write_to(out, fmt);
+}
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,321 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "LinkedList.h"
+#include "PackedLinkedList.h"
+#include "PersistentList.h"
+
+/**
+ * @brief 计时工具. 运行 f 一次，返回耗时 (毫秒).
+ *
+ * @param f 被计时的函数.
+ * @return double 耗时.
+ */
+template <typename F>
+double timeIt(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
+}
+
+/**
+ * @brief 防止编译器把结果优化掉.
+ *
+ */
+volatile long long sink;
+
+/// std::forward_list 没有 push_back, 只能自己记住最后一个元素, 用 insert_after 在它后面插入.
+struct ForwardListQueue
+{
+    std::forward_list<int> list;
+    std::forward_list<int>::iterator last = list.before_begin();
+
+    void push_back(int x)
+    {
+        last = list.insert_after(last, x);
+    }
+
+    void pop_front()
+    {
+        list.pop_front();
+        if (list.empty())
+            last = list.before_begin();
+    }
+
+    int front() const
+    {
+        return list.front();
+    }
+
+    auto begin() const
+    {
+        return list.begin();
+    }
+
+    auto end() const
+    {
+        return list.end();
+    }
+};
+
+/**
+ * @brief 队列测试: 从表尾插入 n 个元素再从表头全部删除; 然后维持一个长度为 n 的队列,
+ * 做 n 次 push_back + pop_front; 最后遍历一遍求和.
+ *
+ * @tparam Q 被测试的队列类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename Q>
+void fifo(int n, const char *name)
+{
+    double fill = timeIt([n] {
+        Q q;
+        for (int i = 0; i < n; ++i)
+            q.push_back(i);
+        long long sum = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            sum += q.front();
+            q.pop_front();
+        }
+        sink = sum;
+    });
+
+    Q q;
+    for (int i = 0; i < n; ++i)
+        q.push_back(i);
+    double steady = timeIt([&q, n] {
+        for (int i = 0; i < n; ++i)
+        {
+            q.push_back(i);
+            q.pop_front();
+        }
+    });
+    double scan = timeIt([&q] {
+        long long sum = 0;
+        for (int x : q)
+            sum += x;
+        sink = sum;
+    });
+
+    std::cout << name << "\tn = " << n
+              << "\tfill + drain: " << fill << " ms"
+              << "\tsteady queue: " << steady << " ms"
+              << "\tscan: " << scan << " ms" << std::endl;
+}
+
+void benchFifo()
+{
+    std::cout << "== FIFO: SingleLinkedList vs std::forward_list vs std::deque ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        fifo<SingleLinkedList<int>>(n, "SingleLinkedList");
+        fifo<ForwardListQueue>(n, "forward_list    ");
+        fifo<std::deque<int>>(n, "deque           ");
+    }
+}
+
+/**
+ * @brief 栈测试: 从表头插入 n 个元素再从表头全部删除.
+ *
+ * @tparam S 被测试的类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename S>
+void stack(int n, const char *name)
+{
+    double t = timeIt([n] {
+        S s;
+        for (int i = 0; i < n; ++i)
+            s.push_front(i);
+        long long sum = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            sum += s.front();
+            s.pop_front();
+        }
+        sink = sum;
+    });
+
+    std::cout << name << "\tn = " << n << "\tpush_front + pop_front: " << t << " ms" << std::endl;
+}
+
+void benchStack()
+{
+    std::cout << "== LIFO at the front ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        stack<SingleLinkedList<int>>(n, "SingleLinkedList");
+        stack<std::forward_list<int>>(n, "forward_list    ");
+        stack<std::deque<int>>(n, "deque           ");
+    }
+}
+
+/**
+ * @brief 查找测试: 在 n 个元素中 find 随机的 lookups 个值, 其中一半不存在 (要扫描整张表).
+ *
+ * @tparam L 被测试的表类型.
+ * @tparam T 元素类型.
+ * @param n 元素个数.
+ * @param lookups 查找次数.
+ * @param name 输出时的名字.
+ */
+template <typename L, typename T>
+void search(int n, int lookups, const char *name)
+{
+    L list;
+    for (int i = 0; i < n; ++i)
+        list.push_back(static_cast<T>(i));
+    unsigned seed = 1;
+    double t = timeIt([&] {
+        long long hits = 0;
+        for (int i = 0; i < lookups; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            hits += list.find(static_cast<T>(i % 2 == 0 ? (seed >> 8) % n : n + i));
+        }
+        sink = hits;
+    });
+
+    std::cout << name << "\tn = " << n << "\tfind x" << lookups << ": " << t << " ms"
+              << "\t(SIMD level " << static_cast<int>(SimdFind::level()) << ")" << std::endl;
+}
+
+void benchFind()
+{
+    std::cout << "== find: SingleLinkedList vs PackedSingleLinkedList ==" << std::endl;
+    search<SingleLinkedList<int>, int>(1000000, 100, "SingleLinkedList<int>        ");
+    search<PackedSingleLinkedList<int>, int>(1000000, 100, "PackedSingleLinkedList<int>  ");
+    search<SingleLinkedList<double>, double>(1000000, 100, "SingleLinkedList<double>     ");
+    search<PackedSingleLinkedList<double>, double>(1000000, 100, "PackedSingleLinkedList<double>");
+}
+
+/**
+ * @brief 多线程读测试: threads 个线程一共在 n 个元素中查找 lookups 次. 原来只能用一把锁保护
+ * 会移动 currentPos 的 find; 现在每个线程拿自己的 Cursor 调用 const 的 find, 不需要加锁.
+ *
+ * @param n 元素个数.
+ * @param lookups 查找总次数.
+ * @param threads 线程数.
+ */
+void readers(int n, int lookups, int threads)
+{
+    SingleLinkedList<int> list;
+    for (int i = 0; i < n; ++i)
+        list.push_back(i);
+
+    auto run = [&](auto lookup) {
+        return timeIt([&] {
+            std::vector<std::thread> pool;
+            std::vector<long long> hits(threads);
+            for (int t = 0; t < threads; ++t)
+                pool.emplace_back([&, t] {
+                    unsigned seed = t + 1;
+                    for (int i = t; i < lookups; i += threads)
+                    {
+                        seed = seed * 1103515245 + 12345;
+                        hits[t] += lookup(static_cast<int>((seed >> 8) % n));
+                    }
+                });
+            for (auto &th : pool)
+                th.join();
+            for (long long h : hits)
+                sink = sink + h;
+        });
+    };
+
+    std::mutex m;
+    double locked = run([&](int x) {
+        std::lock_guard<std::mutex> lock(m);
+        return list.find(x);
+    });
+    double cursors = run([&](int x) {
+        auto c = list.before_begin();
+        return list.find(x, c);
+    });
+
+    std::cout << "threads = " << threads << "\tn = " << n << "\tlookups = " << lookups
+              << "\tmutex + currentPos: " << locked << " ms"
+              << "\tCursor per thread: " << cursors << " ms" << std::endl;
+}
+
+void benchReaders()
+{
+    std::cout << "== concurrent lookups ==" << std::endl;
+    for (int threads = 1; threads <= 8; threads *= 2)
+        readers(100000, 4000, threads);
+}
+
+/**
+ * @brief 快照测试: 写者在一张 n 个元素的表头不断插入, 每插入 every 个元素给读者留一份快照,
+ * 一共 snapshots 份. SingleLinkedList 只能整张拷贝, PersistentList 的快照只是增加一个引用计数.
+ *
+ * @tparam L 被测试的表类型.
+ * @param n 初始元素个数.
+ * @param snapshots 快照份数.
+ * @param every 两次快照之间插入的元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void snapshot(int n, int snapshots, int every, const char *name)
+{
+    L live;
+    for (int i = 0; i < n; ++i)
+        live.push_front(i);
+    std::vector<L> kept;
+    double t = timeIt([&] {
+        for (int k = 0; k < snapshots; ++k)
+        {
+            for (int i = 0; i < every; ++i)
+                live.push_front(i);
+            kept.push_back(live);
+        }
+    });
+    double release = timeIt([&] { kept.clear(); });
+
+    std::cout << name << "\tn = " << n << "\tsnapshots x" << snapshots
+              << ": " << t << " ms\tdropping them: " << release << " ms" << std::endl;
+}
+
+void benchSnapshot()
+{
+    std::cout << "== snapshots while writing ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        snapshot<SingleLinkedList<int>>(n, 100, 100, "SingleLinkedList");
+        snapshot<PersistentList<int>>(n, 100, 100, "PersistentList  ");
+    }
+}
+
+/**
+ * @brief 用法: ./benchmark [suite]. 不带参数时运行全部测试.
+ *
+ */
+int main(int argc, char *argv[])
+{
+    const char *suite = argc > 1 ? argv[1] : "all";
+    bool all = std::strcmp(suite, "all") == 0;
+
+    if (all || std::strcmp(suite, "fifo") == 0)
+        benchFifo();
+    if (all || std::strcmp(suite, "stack") == 0)
+        benchStack();
+    if (all || std::strcmp(suite, "find") == 0)
+        benchFind();
+    if (all || std::strcmp(suite, "readers") == 0)
+        benchReaders();
+    if (all || std::strcmp(suite, "snapshot") == 0)
+        benchSnapshot();
+
+    return 0;
+}
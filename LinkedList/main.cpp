@@ -1,4 +1,93 @@
 #include "LinkedList.h"
+#include "PackedLinkedList.h"
+#include "PersistentList.h"
+#include "IntrusiveLinkedList.h"
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+
+/// 侵入式单链表的元素，自己带着挂钩，可以同时挂在两张表上
+struct Ready {};
+struct Task : SListHook<>, SListHook<Ready>
+{
+    int id;
+    Task(int _id = 0) : id{_id} {}
+    friend std::ostream& operator << (std::ostream& out, const Task &rhs){
+        return out << "#" << rhs.id;
+    }
+};
+
+/// 拷贝时报警的元素，用来检查插入和移动的过程中有没有多余的拷贝
+class MyData
+{
+private:
+    int a, b;
+
+public:
+    MyData(int a = 0, int b = 0) : a(a), b(b) {}
+    bool operator == (const MyData &rhs) const{
+        return a == rhs.a && b == rhs.b;
+    }
+
+    static bool checkCopy;
+    static int copies;
+
+    MyData(const MyData &rhs) : a(rhs.a), b(rhs.b) {
+        ++copies;
+        if(checkCopy) std::cerr << "Warning: element copy happened!" << std::endl;
+    }
+    MyData& operator = (const MyData &rhs){
+        a = rhs.a;
+        b = rhs.b;
+        ++copies;
+        if(checkCopy) std::cerr << "Warning: element copy happened!" << std::endl;
+        return *this;
+    }
+    MyData(MyData &&) = default;
+    MyData& operator = (MyData &&) = default;
+
+    friend std::ostream& operator << (std::ostream& out, const MyData &rhs){
+        out << "(" << rhs.a << "," << rhs.b << ")";
+        return out;
+    }
+};
+
+bool MyData::checkCopy = false;
+int MyData::copies = 0;
+
+/// 拷贝到第 budget 次时抛出异常的元素，用来检查拷贝中途失败时表是否完整、有没有泄漏
+struct Fragile
+{
+    std::string s;
+    std::string heap = std::string(32, '-');    ///< 放在堆上，泄漏时能被检查出来
+    static int budget;
+
+    Fragile(const char *_s) : s{_s} {}
+    Fragile(const Fragile &rhs) : s{rhs.s}, heap{rhs.heap} { spend(); }
+    Fragile& operator = (const Fragile &rhs){
+        spend();
+        s = rhs.s;
+        return *this;
+    }
+    static void spend(){
+        if (budget-- == 0)
+            throw std::runtime_error("copy failed");
+    }
+    friend std::ostream& operator << (std::ostream& out, const Fragile &rhs){
+        return out << rhs.s;
+    }
+};
+
+int Fragile::budget = -1;
+
+SingleLinkedList<MyData> makeList(int n)
+{
+    SingleLinkedList<MyData> l;
+    for (int i = 0; i < n; ++i)
+        l.emplace_back(i, i * i);
+    return l;
+}
 
 int main()
 {
@@ -36,5 +125,204 @@ int main()
     c1.printList();
     c2.printList(); //测试【删除】操作是否正确，每种情况6分
 
+    c3.write_to(std::cout);                     // 与 printList 的内容相同，以空格分隔
+    c3.write_to(std::cout, {", ", " ;\n"});     // 自定义分隔符和结尾
+    e.write_to(std::cout);                      // 空链表只输出结尾
+
+    SingleLinkedList<int> q;
+    for (int i = 1; i <= 5; ++i)
+        q.push_back(i);
+    q.push_front(0);
+    q.pop_front();
+    q.pop_front();
+    std::cout << q.front() << " " << q.back() << " " << q.getSize() << std::endl; // 2 5 4
+    for (int &x : q)
+        x *= 10;
+    const SingleLinkedList<int> &cq = q;
+    for (auto it = cq.begin(); it != cq.end(); ++it)
+        std::cout << *it << " ";
+    std::cout << std::endl;                     // 20 30 40 50
+    q.find(50);
+    q.insert(60);                               // 插在最后一个元素后面，tail 随之更新
+    q.push_back(70);
+    q.printList();                              // 20 30 40 50 60 70
+    while (!q.isEmpty())
+        q.pop_front();
+    q.push_back(1);                             // 清空之后 head 和 tail 都重新开始
+    std::cout << q.front() << " " << q.back() << std::endl; // 1 1
+    SingleLinkedList<int> r{q};
+    r.push_back(2);
+    r.printList();                              // 1 2
+    r = q;                                      // 赋值之后 tail 指向新的最后一个节点
+    r.push_back(3);
+    r.printList();                              // 1 3
+
+    // 按块连续存放的单链表，find 用向量指令比较，currentPos 的含义不变
+    PackedSingleLinkedList<int, 4> pk{1, 2, 3, 4, 5, 6};
+    std::cout << pk.getCurrentVal() << std::endl;   // 6
+    std::cout << pk.find(3) << " " << pk.getCurrentVal() << std::endl; // 1 3
+    pk.insert(30);                                  // 块满了，对半分裂
+    pk.insert(31);
+    std::cout << pk.find(7) << " " << pk.getCurrentVal() << std::endl; // 0 31
+    pk.printList();                                 // 1 2 3 30 31 4 5 6
+    pk.remove();
+    pk.remove();
+    pk.remove();
+    pk.printList();                                 // 1 2 3 30 31
+    std::cout << pk.getSize() << std::endl;         // 5
+    PackedSingleLinkedList<double> pd;
+    for (int i = 0; i < 1000; ++i)
+        pd.push_back(i * 0.5);
+    std::cout << pd.find(321.5) << " " << pd.getCurrentVal() << " "
+              << pd.find(0.25) << std::endl;        // 1 321.5 0
+
+    // 各自带位置的 Cursor，不影响 currentPos
+    SingleLinkedList<int> cs{1, 2, 3, 4};
+    cs.find(2);
+    auto cur1 = cs.before_begin();
+    auto cur2 = cs.before_begin();
+    cs.find(3, cur1);
+    cs.insert_after(cur1, 30);                    // 3 后面插入 30，cur1 移到 30
+    cs.insert_after(cur2, 0);                     // 在表头插入 0
+    cs.remove_after(cur1);                        // 删除 30 后面的 4，tail 退回 30
+    cs.push_back(5);
+    cs.printList();                             // 0 1 2 3 30 5
+    std::cout << cur1.get() << " " << cur2.get() << " " << cs.getCurrentVal() << std::endl; // 30 0 2
+    auto cur3 = cs.current();
+    cs.remove_after(cur3);                        // 删除 2 后面的 3
+    std::cout << cur2.advance(cs) << " " << cur2.get() << std::endl; // 1 1
+    cs.printList();                             // 0 1 2 30 5
+
+    // 多个线程各用自己的 Cursor 同时查找
+    SingleLinkedList<int> shared;
+    for (int i = 0; i < 1000; ++i)
+        shared.push_back(i);
+    std::atomic<int> hits{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+        readers.emplace_back([&shared, &hits, t] {
+            auto c = shared.before_begin();
+            for (int i = t; i < 2000; i += 4)
+                if (shared.find(i, c) && c.get() == i)
+                    ++hits;
+        });
+    for (auto &th : readers)
+        th.join();
+    std::cout << hits << " " << shared.getCurrentVal() << std::endl; // 1000 0
+
+    // 插入右值、emplace 和移动都不应该拷贝元素
+    MyData::checkCopy = true;
+    SingleLinkedList<MyData> md;
+    md.emplace_back(1, 1);
+    md.push_back(MyData(2, 4));
+    md.emplace_front(0, 0);
+    md.find(MyData(1, 1));
+    md.emplace(5, 25);                          // 插在 (1,1) 后面
+    md.insert(MyData(6, 36));
+    auto mc = md.before_begin();
+    md.emplace_after(mc, -1, 1);
+    SingleLinkedList<MyData> moved(std::move(md));
+    md = std::move(moved);
+    SingleLinkedList<MyData> made = makeList(3);
+    made = makeList(4);
+    MyData::checkCopy = false;
+    md.printList();                             // (-1,1) (0,0) (1,1) (5,25) (6,36) (2,4)
+    made.printList();                           // (0,0) (1,1) (2,4) (3,9)
+    std::cout << moved.isEmpty() << " " << moved.getSize() << " "
+              << MyData::copies << std::endl;   // 1 0 0
+    moved.push_back(MyData(7, 49));             // 被移动过的表可以继续使用
+    moved.printList();                          // (7,49)
+
+    // 拷贝中途抛出异常: 拷贝构造不泄漏已经拷好的元素，拷贝赋值之后 tail 仍然指向最后一个节点
+    SingleLinkedList<Fragile> src;
+    for (const char *x : {"a", "b", "c", "d", "e"})
+        src.emplace_back(x);
+    Fragile::budget = 2;
+    try { SingleLinkedList<Fragile> cp(src); } catch (const std::runtime_error &) { std::cout << "copy failed "; }
+    SingleLinkedList<Fragile> dst;
+    dst.emplace_back("x");
+    Fragile::budget = 3;
+    try { dst = src; } catch (const std::runtime_error &) { std::cout << "assign failed" << std::endl; }
+    Fragile::budget = -1;                       // copy failed assign failed
+    dst.emplace_back("z");
+    dst.printList();                            // a b c z
+    std::cout << dst.getSize() << " " << dst.back() << std::endl; // 4 z
+
+    // 持久化的单链表: 修改只影响当前句柄，快照是 O(1) 的，新旧版本共享节点
+    PersistentList<int> v1{2, 3, 4};
+    PersistentList<int> v2 = v1;                // 快照
+    v2.push_front(1);
+    PersistentList<int> v3 = v1.tail();
+    v1.pop_front();
+    v1.push_front(20);
+    v1.printList();                             // 20 3 4
+    v2.printList();                             // 1 2 3 4
+    v3.printList();                             // 3 4
+    std::cout << v2.getSize() << " " << v2.front() << " " << v3.sharesWith(v2.tail().tail())
+              << " " << v1.contains(2) << " " << v2.contains(2) << std::endl; // 4 1 1 0 1
+    v2.write_to(std::cout, {", ", "\n"});       // 1, 2, 3, 4
+    v2.emptyList();
+    v3 = std::move(v1);
+    v3.printList();                             // 20 3 4
+    std::cout << v1.isEmpty() << " " << v2.isEmpty() << std::endl; // 1 1
+
+    // 一个线程不断修改，其它线程读取各自拿到的快照
+    PersistentList<int> live;
+    std::vector<PersistentList<int>> snaps;
+    for (int i = 0; i < 1000; ++i)
+    {
+        live.push_front(i);
+        if (i % 100 == 99)
+            snaps.push_back(live);
+    }
+    std::atomic<long long> total{0};
+    std::vector<std::thread> snapReaders;
+    for (int t = 0; t < 4; ++t)
+        snapReaders.emplace_back([&snaps, &total, t] {
+            for (int k = t; k < (int)snaps.size(); k += 4)
+            {
+                PersistentList<int> mine = snaps[k];
+                long long sum = 0;
+                for (int x : mine)
+                    sum += x;
+                total += sum;
+            }
+        });
+    for (int i = 0; i < 1000; ++i)
+        live.pop_front();
+    for (auto &th : snapReaders)
+        th.join();
+    std::cout << total << " " << live.isEmpty() << std::endl; // 1922250 1
+
+    // 侵入式单链表: 元素放在调用者自己的数组里，表只串起它们身上的挂钩
+    std::vector<Task> tasks;
+    for (int i = 0; i < 5; ++i)
+        tasks.emplace_back(i);
+    IntrusiveSingleLinkedList<Task> all;
+    IntrusiveSingleLinkedList<Task, Ready> ready;
+    for (auto &t : tasks)
+    {
+        all.push_back(t);
+        if (t.id % 2 == 0)
+            ready.push_front(t);
+    }
+    all.printList();                            // #0 #1 #2 #3 #4
+    ready.printList();                          // #4 #2 #0
+    all.remove_after(tasks[1]);                 // O(1) 删除 #2，ready 中的 #2 不受影响
+    all.insert_after(tasks[4], tasks[2]);
+    std::cout << all.remove(tasks[0]) << " " << all.remove(tasks[0]) << " "
+              << all.front() << " " << all.back() << std::endl; // 1 0 #1 #2
+    all.printList();                            // #1 #3 #4 #2
+    try { ready.push_back(tasks[4]); }
+    catch (const std::invalid_argument &e) { std::cout << e.what() << std::endl; } // Element is already linked into a list
+    IntrusiveSingleLinkedList<Task> later = std::move(all);
+    later.pop_front();
+    later.push_back(tasks[0]);
+    later.printList();                          // #3 #4 #2 #0
+    std::cout << all.isEmpty() << " " << later.getSize() << " " << ready.getSize() << std::endl; // 1 4 3
+    later.emptyList();
+    std::cout << tasks[4].SListHook<>::is_linked() << " "
+              << tasks[4].SListHook<Ready>::is_linked() << std::endl; // 0 1
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,401 @@
+#ifndef __CONCURRENT_QUEUE_MARK__
+#define __CONCURRENT_QUEUE_MARK__
+
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 危险指针 (hazard pointers), 用于无锁结构的内存回收.
+ *
+ * 无锁队列里一个线程摘下节点之后, 别的线程可能还拿着指向它的指针正在读, 所以不能马上 delete.
+ * 做法是: 每个线程在解引用一个共享指针之前, 先把它登记到自己的危险指针槽里; 要释放节点的线程
+ * 先把节点放进自己的待回收列表, 攒够一批后扫描所有线程的槽, 只释放没有被任何线程登记的节点.
+ *
+ * 每个线程第一次使用时领取一条记录 (Record), 线程结束时归还给后来的线程复用.
+ * 线程结束时仍不能释放的节点交给一个全局的孤儿列表, 由之后的扫描处理.
+ * 所有 ConcurrentQueue 共用这一套记录.
+ */
+class HazardPointers
+{
+public:
+    static constexpr int SLOTS = 2; /**<! 每个线程同时最多保护的指针个数. */
+
+    /**
+     * @brief 读取 src 并用当前线程的第 i 个槽保护它. 登记之后要再读一次 src,
+     * 确认登记期间它没有变, 否则登记的可能是一个已经被摘下甚至被释放的节点.
+     *
+     * @param i 槽的编号.
+     * @param src 共享的原子指针.
+     * @return T* 受保护的指针, 在 clear(i) 之前不会被释放.
+     */
+    template <typename T>
+    static T *protect(int i, const std::atomic<T *> &src)
+    {
+        std::atomic<void *> &hp = local().record->hp[i];
+        T *p = src.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            hp.store(p, std::memory_order_seq_cst);
+            T *q = src.load(std::memory_order_seq_cst);
+            if (q == p)
+                return p;
+            p = q;
+        }
+    }
+
+    /**
+     * @brief 清除当前线程的第 i 个槽.
+     *
+     * @param i 槽的编号.
+     */
+    static void clear(int i)
+    {
+        local().record->hp[i].store(nullptr, std::memory_order_release);
+    }
+
+    /**
+     * @brief 延迟释放 p. 它会在没有任何线程保护它的时候被 delete.
+     *
+     * @param p 已经从共享结构中摘下的对象.
+     */
+    template <typename T>
+    static void retire(T *p)
+    {
+        local().retire(p, [](void *q) { delete static_cast<T *>(q); });
+    }
+
+private:
+    /**
+     * @brief 一个线程的危险指针记录. 记录只增不减, 线程退出后由别的线程复用.
+     */
+    struct Record
+    {
+        std::atomic<void *> hp[SLOTS] = {}; /**<! 危险指针槽. */
+        std::atomic<bool> active{false};     /**<! 是否有线程正在使用. */
+        Record *next = nullptr;              /**<! 记录链表. */
+    };
+
+    /**
+     * @brief 一个待回收的对象, 连同释放它的方法.
+     */
+    struct Retired
+    {
+        void *ptr;
+        void (*deleter)(void *);
+    };
+
+    /**
+     * @brief 每个线程自己的状态: 领到的记录和待回收列表.
+     */
+    struct Local
+    {
+        Record *record;
+        std::vector<Retired> retired;
+
+        Local() : record{acquire()}
+        {
+        }
+
+        ~Local()
+        {
+            for (auto &hp : record->hp)
+                hp.store(nullptr, std::memory_order_release);
+            scan();
+            if (!retired.empty())
+            {
+                std::lock_guard<std::mutex> lock(orphanMutex());
+                orphans().insert(orphans().end(), retired.begin(), retired.end());
+            }
+            record->active.store(false, std::memory_order_release);
+        }
+
+        void retire(void *p, void (*deleter)(void *))
+        {
+            retired.push_back({p, deleter});
+            if (retired.size() >= threshold())
+                scan();
+        }
+
+        /**
+         * @brief 收集所有线程登记的指针, 释放其中没有出现的待回收对象.
+         */
+        void scan()
+        {
+            {
+                std::lock_guard<std::mutex> lock(orphanMutex());
+                retired.insert(retired.end(), orphans().begin(), orphans().end());
+                orphans().clear();
+            }
+            std::vector<void *> hazards;
+            for (Record *r = records().load(std::memory_order_acquire); r != nullptr; r = r->next)
+                for (auto &hp : r->hp)
+                    if (void *p = hp.load(std::memory_order_seq_cst))
+                        hazards.push_back(p);
+            std::sort(hazards.begin(), hazards.end());
+            auto keep = std::partition(retired.begin(), retired.end(), [&hazards](const Retired &x) {
+                return std::binary_search(hazards.begin(), hazards.end(), x.ptr);
+            });
+            for (auto it = keep; it != retired.end(); ++it)
+                it->deleter(it->ptr);
+            retired.erase(keep, retired.end());
+        }
+    };
+
+    static std::atomic<Record *> &records()
+    {
+        static std::atomic<Record *> head{nullptr};
+        return head;
+    }
+
+    static std::atomic<std::size_t> &recordCount()
+    {
+        static std::atomic<std::size_t> n{0};
+        return n;
+    }
+
+    static std::mutex &orphanMutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    static std::vector<Retired> &orphans()
+    {
+        static std::vector<Retired> v;
+        return v;
+    }
+
+    /**
+     * @brief 待回收列表的长度达到所有槽总数的两倍时扫描一次, 这样每次扫描至少能释放一半, 摊还 O(1).
+     */
+    static std::size_t threshold()
+    {
+        return 2 * SLOTS * recordCount().load(std::memory_order_relaxed) + 32;
+    }
+
+    /**
+     * @brief 领取一条空闲的记录, 没有就新建一条挂到链表头部.
+     */
+    static Record *acquire()
+    {
+        for (Record *r = records().load(std::memory_order_acquire); r != nullptr; r = r->next)
+        {
+            bool expected = false;
+            if (!r->active.load(std::memory_order_relaxed) &&
+                r->active.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                return r;
+        }
+        Record *r = new Record;
+        r->active.store(true, std::memory_order_relaxed);
+        Record *head = records().load(std::memory_order_relaxed);
+        do
+            r->next = head;
+        while (!records().compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+        recordCount().fetch_add(1, std::memory_order_relaxed);
+        return r;
+    }
+
+    static Local &local()
+    {
+        thread_local Local l;
+        return l;
+    }
+};
+
+/**
+ * @brief 多生产者多消费者的无锁队列 (Michael-Scott 队列).
+ *
+ * 与 List 一样使用哨兵节点: head 总是指向一个不含数据的哨兵, 真正的第一个元素在 head->next.
+ * 出队时把 head 移到 head->next, 原来的第一个数据节点就成了新的哨兵. 因为有哨兵, 入队只改
+ * tail 一端, 出队只改 head 一端, 两端的线程互不干扰.
+ *
+ * 入队分两步: 先用 CAS 把新节点挂到 tail->next 上, 再把 tail 向后推. 第二步可能被别的线程
+ * 抢先完成, 所以任何线程看到 tail->next 不为空时都会顺手帮忙推一下 tail.
+ *
+ * 被摘下的哨兵通过 HazardPointers 延迟释放.
+ *
+ * @tparam Object 元素类型. 出队时 head 的 CAS 已经成功, 元素已经离开队列, 之后再把它
+ * 移动给调用者就不能失败, 所以要求移动赋值不抛异常.
+ */
+template <typename Object>
+class ConcurrentQueue
+{
+    static_assert(std::is_nothrow_move_assignable<Object>::value,
+                  "try_pop moves the element out after it has left the queue, so it must not throw");
+
+private:
+    /**
+     * @brief 队列节点. 数据用 placement new 构造在 storage 中, 哨兵的 storage 是空的.
+     */
+    struct Node
+    {
+        std::atomic<Node *> next{nullptr};                   /**<! 后一个节点. */
+        alignas(Object) unsigned char storage[sizeof(Object)]; /**<! 数据的存储空间. */
+
+        Object &data()
+        {
+            return *std::launder(reinterpret_cast<Object *>(storage));
+        }
+    };
+
+    /// head 和 tail 分别被消费者和生产者频繁修改, 放在不同的缓存行上避免伪共享.
+    alignas(64) std::atomic<Node *> head;
+    alignas(64) std::atomic<Node *> tail;
+
+public:
+    /**
+     * @brief 构造一个只有哨兵的空队列.
+     *
+     */
+    ConcurrentQueue()
+    {
+        Node *dummy = new Node;
+        head.store(dummy, std::memory_order_relaxed);
+        tail.store(dummy, std::memory_order_relaxed);
+    }
+
+    ConcurrentQueue(const ConcurrentQueue &) = delete;
+    ConcurrentQueue &operator=(const ConcurrentQueue &) = delete;
+
+    /**
+     * @brief 析构函数. 此时不应再有线程访问队列, 直接释放剩下的节点.
+     *
+     */
+    ~ConcurrentQueue()
+    {
+        Node *p = head.load(std::memory_order_relaxed);
+        Node *n = p->next.load(std::memory_order_relaxed);
+        delete p;
+        while (n != nullptr)
+        {
+            n->data().~Object();
+            p = n;
+            n = n->next.load(std::memory_order_relaxed);
+            delete p;
+        }
+    }
+
+    /**
+     * @brief 入队一个左值.
+     *
+     * @param x 元素.
+     */
+    void push(const Object &x)
+    {
+        emplace(x);
+    }
+
+    /**
+     * @brief 入队一个右值.
+     *
+     * @param x 元素.
+     */
+    void push(Object &&x)
+    {
+        emplace(std::move(x));
+    }
+
+    /**
+     * @brief 用 args 构造一个元素并入队. 节点在挂上队列之前就构造好, 构造过程不需要同步.
+     *
+     * @param args 传给 Object 构造函数的参数.
+     */
+    template <typename... Args>
+    void emplace(Args &&...args)
+    {
+        Node *node = new Node;
+        try
+        {
+            ::new (node->storage) Object(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            delete node;
+            throw;
+        }
+
+        for (;;)
+        {
+            Node *t = HazardPointers::protect(0, tail);
+            Node *next = t->next.load(std::memory_order_acquire);
+            if (t != tail.load(std::memory_order_acquire))
+                continue;
+            if (next == nullptr)
+            {
+                if (t->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    /// 失败也没关系, 说明别的线程已经帮我们推过了.
+                    tail.compare_exchange_strong(t, node, std::memory_order_release, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            else
+                tail.compare_exchange_weak(t, next, std::memory_order_release, std::memory_order_relaxed);
+        }
+        HazardPointers::clear(0);
+    }
+
+    /**
+     * @brief 尝试出队. 队列为空时立即返回 false, 不会阻塞.
+     *
+     * @param out 出队的元素被移动到这里.
+     * @return true 成功出队.
+     * @return false 队列为空.
+     */
+    bool try_pop(Object &out)
+    {
+        for (;;)
+        {
+            Node *h = HazardPointers::protect(0, head);
+            Node *t = tail.load(std::memory_order_acquire);
+            Node *next = HazardPointers::protect(1, h->next);
+            if (h != head.load(std::memory_order_acquire))
+                continue;
+            if (next == nullptr)
+            {
+                HazardPointers::clear(0);
+                HazardPointers::clear(1);
+                return false;
+            }
+            if (h == t)
+            {
+                /// tail 落后了, 先帮入队的线程把它推上去.
+                tail.compare_exchange_weak(t, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (head.compare_exchange_strong(h, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                /// 只有 CAS 成功的线程会读 next 的数据, next 被槽 1 保护着, 不会被释放.
+                out = std::move(next->data());
+                next->data().~Object();
+                HazardPointers::clear(0);
+                HazardPointers::clear(1);
+                HazardPointers::retire(h);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief 队列是否为空. 并发修改时只是一个瞬间的快照.
+     *
+     * @return true 空.
+     * @return false 非空.
+     */
+    bool empty() const
+    {
+        Node *h = HazardPointers::protect(0, head);
+        bool result = h->next.load(std::memory_order_acquire) == nullptr;
+        HazardPointers::clear(0);
+        return result;
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
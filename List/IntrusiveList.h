@@ -0,0 +1,506 @@
+#ifndef __INTRUSIVE_LIST_MARK__
+#define __INTRUSIVE_LIST_MARK__
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @brief 侵入式链表的挂钩. 想要放进 IntrusiveList 的类型公有继承它, 前后指针就在对象自己身上,
+ * 链表不再为每个元素分配节点.
+ *
+ * 一个对象要同时挂在几张表上时, 用不同的 Tag 继承几个挂钩, 每个挂钩对应一张表.
+ *
+ * @tparam Tag 区分同一个类型上多个挂钩的标签, 只用于类型区分.
+ */
+template <typename Tag = void>
+struct IntrusiveHook
+{
+    IntrusiveHook *prev = nullptr; /**<! 前一个挂钩, 不在表中时为 nullptr. */
+    IntrusiveHook *next = nullptr; /**<! 后一个挂钩, 不在表中时为 nullptr. */
+
+    IntrusiveHook() = default;
+
+    /**
+     * @brief 拷贝对象时不拷贝它在表中的位置, 新对象总是不在任何表中.
+     */
+    IntrusiveHook(const IntrusiveHook &)
+    {
+    }
+
+    /**
+     * @brief 赋值时两边各自留在原来的表中, 挂钩保持不变.
+     */
+    IntrusiveHook &operator=(const IntrusiveHook &)
+    {
+        return *this;
+    }
+
+    /**
+     * @brief 当前是否挂在某张表上.
+     *
+     * @return true 在表中.
+     */
+    bool is_linked() const
+    {
+        return next != nullptr;
+    }
+};
+
+/**
+ * @brief 侵入式双向链表. 接口与 List 相近, 但元素不属于链表: 表中只是把元素身上的
+ * IntrusiveHook 串起来, 元素由调用者自己创建和销毁 (在栈上, 数组里, 对象池里都可以).
+ * 所以插入和删除不分配也不释放任何内存, 遍历时也少了一次从节点到元素的间接访问.
+ *
+ * 手上只有元素的引用时, erase(x) 和 iterator_to(x) 都是 O(1) 的, 不需要先在表中查找.
+ *
+ * 调用者要保证元素在表中时不被销毁或移走. 表析构或 clear 时只是把所有元素摘下来,
+ * 不会析构它们. 同一个挂钩同时只能在一张表中, 往表中插入已经挂在表上的元素会抛出
+ * std::invalid_argument.
+ *
+ * @tparam T 元素类型, 必须公有继承 IntrusiveHook<Tag>.
+ * @tparam Tag 使用 T 的哪个挂钩.
+ */
+template <typename T, typename Tag = void>
+class IntrusiveList
+{
+    using Hook = IntrusiveHook<Tag>;
+    static_assert(std::is_base_of<Hook, T>::value, "T must derive from IntrusiveHook<Tag>");
+
+public:
+    /**
+     * @brief 只读的双向迭代器, 内部是指向挂钩的指针.
+     */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : current{nullptr}
+        {
+        }
+
+        const T &operator*() const
+        {
+            return static_cast<const T &>(*current);
+        }
+
+        const T *operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator &operator++()
+        {
+            current = current->next;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        const_iterator &operator--()
+        {
+            current = current->prev;
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            const_iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        bool operator==(const const_iterator &rhs) const
+        {
+            return current == rhs.current;
+        }
+
+        bool operator!=(const const_iterator &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    protected:
+        Hook *current; /**<! 当前元素的挂钩, 或者是表的哨兵. */
+
+        const_iterator(Hook *p) : current{p}
+        {
+        }
+
+        friend class IntrusiveList<T, Tag>;
+    };
+
+    /**
+     * @brief 可写的双向迭代器.
+     */
+    class iterator : public const_iterator
+    {
+    public:
+        using pointer = T *;
+        using reference = T &;
+
+        iterator()
+        {
+        }
+
+        T &operator*() const
+        {
+            return static_cast<T &>(*this->current);
+        }
+
+        T *operator->() const
+        {
+            return &**this;
+        }
+
+        iterator &operator++()
+        {
+            this->current = this->current->next;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        iterator &operator--()
+        {
+            this->current = this->current->prev;
+            return *this;
+        }
+
+        iterator operator--(int)
+        {
+            iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+    protected:
+        iterator(Hook *p) : const_iterator{p}
+        {
+        }
+
+        friend class IntrusiveList<T, Tag>;
+    };
+
+    /**
+     * @brief 构造一张空表. 两个哨兵是表自己的成员, 不分配内存.
+     */
+    IntrusiveList()
+    {
+        init();
+    }
+
+    /// 元素不属于表, 拷贝一张表没有意义 (挂钩也不能同时在两张表中).
+    IntrusiveList(const IntrusiveList &) = delete;
+    IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+    /**
+     * @brief 移动构造函数. 接管 rhs 的全部元素, 只修改首尾元素指向哨兵的指针.
+     *
+     * @param rhs 被移动的表, 之后为空表.
+     */
+    IntrusiveList(IntrusiveList &&rhs) noexcept
+    {
+        init();
+        takeFrom(rhs);
+    }
+
+    /**
+     * @brief 移动赋值. 原来的元素全部被摘下, 再接管 rhs 的元素.
+     *
+     * @param rhs 被移动的表, 之后为空表.
+     * @return IntrusiveList& 当前表.
+     */
+    IntrusiveList &operator=(IntrusiveList &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            clear();
+            takeFrom(rhs);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 析构时把所有元素摘下来, 元素本身不受影响.
+     */
+    ~IntrusiveList()
+    {
+        clear();
+    }
+
+    iterator begin()
+    {
+        return {head.next};
+    }
+
+    const_iterator begin() const
+    {
+        return {head.next};
+    }
+
+    iterator end()
+    {
+        return {&tail};
+    }
+
+    const_iterator end() const
+    {
+        return {const_cast<Hook *>(&tail)};
+    }
+
+    int size() const
+    {
+        return theSize;
+    }
+
+    bool empty() const
+    {
+        return theSize == 0;
+    }
+
+    /**
+     * @brief 第一个元素. 空表时抛出 std::out_of_range.
+     */
+    T &front()
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access front of an empty list");
+        return *begin();
+    }
+
+    const T &front() const
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access front of an empty list");
+        return *begin();
+    }
+
+    /**
+     * @brief 最后一个元素. 空表时抛出 std::out_of_range.
+     */
+    T &back()
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access back of an empty list");
+        return *--end();
+    }
+
+    const T &back() const
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access back of an empty list");
+        return *--end();
+    }
+
+    void push_front(T &x)
+    {
+        insert(begin(), x);
+    }
+
+    void push_back(T &x)
+    {
+        insert(end(), x);
+    }
+
+    /**
+     * @brief 摘下第一个元素. 空表时什么也不做.
+     */
+    void pop_front()
+    {
+        erase(begin());
+    }
+
+    /**
+     * @brief 摘下最后一个元素. 空表时什么也不做.
+     */
+    void pop_back()
+    {
+        erase(--end());
+    }
+
+    /**
+     * @brief 把 x 挂在 itr 之前. 只修改四个指针, 不分配内存.
+     *
+     * @param itr 插入位置.
+     * @param x 要插入的元素, 不能已经在某张表中.
+     * @return iterator 指向 x 的迭代器.
+     */
+    iterator insert(iterator itr, T &x)
+    {
+        Hook *h = &x;
+        if (h->is_linked())
+            throw std::invalid_argument("Element is already linked into a list");
+        Hook *p = itr.current;
+        h->prev = p->prev;
+        h->next = p;
+        p->prev->next = h;
+        p->prev = h;
+        ++theSize;
+        return {h};
+    }
+
+    /**
+     * @brief 摘下 itr 处的元素. 与 List::erase 一样, itr 是哨兵时什么也不删.
+     *
+     * @param itr 要删除的位置.
+     * @return iterator 删除位置的下一个迭代器.
+     */
+    iterator erase(iterator itr)
+    {
+        if (itr.current == &tail)
+            return itr;
+        if (itr.current == &head)
+            return ++itr;
+        Hook *h = itr.current;
+        iterator retVal{h->next};
+        unlink(h);
+        --theSize;
+        return retVal;
+    }
+
+    /**
+     * @brief 摘下元素 x. 只凭 x 身上的挂钩就能找到前后元素, O(1). x 必须在当前表中,
+     * 不在任何表中时抛出 std::invalid_argument (在别的表中则无法检测).
+     *
+     * @param x 要删除的元素.
+     * @return iterator x 原来的下一个位置.
+     */
+    iterator erase(T &x)
+    {
+        if (!static_cast<Hook &>(x).is_linked())
+            throw std::invalid_argument("Element is not linked into a list");
+        return erase(iterator_to(x));
+    }
+
+    /**
+     * @brief 摘下 [from, to) 中的元素.
+     *
+     * @param from 起始位置.
+     * @param to 结束位置.
+     * @return iterator to.
+     */
+    iterator erase(iterator from, iterator to)
+    {
+        while (from != to)
+            from = erase(from);
+        return to;
+    }
+
+    /**
+     * @brief 由元素得到指向它的迭代器, O(1). x 必须在当前表中.
+     *
+     * @param x 表中的元素.
+     * @return iterator 指向 x 的迭代器.
+     */
+    iterator iterator_to(T &x)
+    {
+        return {static_cast<Hook *>(&x)};
+    }
+
+    const_iterator iterator_to(const T &x) const
+    {
+        return {const_cast<Hook *>(static_cast<const Hook *>(&x))};
+    }
+
+    /**
+     * @brief 把所有元素摘下来, 每个元素的挂钩都恢复为不在表中. 元素本身不受影响.
+     */
+    void clear()
+    {
+        Hook *p = head.next;
+        while (p != &tail)
+        {
+            Hook *next = p->next;
+            p->prev = p->next = nullptr;
+            p = next;
+        }
+        head.next = &tail;
+        tail.prev = &head;
+        theSize = 0;
+    }
+
+    /**
+     * @brief 把 other 中的全部元素移到 pos 之前, O(1). 元素和挂钩都不动, 只修改首尾的指针.
+     *
+     * @param pos 插入位置.
+     * @param other 另一张表, 之后为空表.
+     */
+    void splice(iterator pos, IntrusiveList &other)
+    {
+        if (this == &other || other.empty())
+            return;
+        Hook *first = other.head.next;
+        Hook *last = other.tail.prev;
+        other.head.next = &other.tail;
+        other.tail.prev = &other.head;
+        Hook *p = pos.current;
+        first->prev = p->prev;
+        last->next = p;
+        p->prev->next = first;
+        p->prev = last;
+        theSize += other.theSize;
+        other.theSize = 0;
+    }
+
+    void printList() const
+    {
+        for (const T &x : *this)
+            std::cout << x << "\t";
+        std::cout << std::endl;
+    }
+
+private:
+    Hook head;       /**<! 头哨兵, 不属于任何元素. */
+    Hook tail;       /**<! 尾哨兵, 不属于任何元素. */
+    int theSize = 0; /**<! 元素个数. */
+
+    void init()
+    {
+        head.next = &tail;
+        tail.prev = &head;
+    }
+
+    /**
+     * @brief 把 h 从前后之间摘下来, 并恢复为不在表中.
+     *
+     * @param h 表中元素的挂钩.
+     */
+    static void unlink(Hook *h)
+    {
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = h->next = nullptr;
+    }
+
+    /**
+     * @brief 接管 from 的全部元素. 调用前当前表必须是空的.
+     *
+     * @param from 另一张表, 之后为空表.
+     */
+    void takeFrom(IntrusiveList &from)
+    {
+        splice(end(), from);
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -1,27 +1,46 @@
 #include "List.h"
+#include "UnrolledList.h"
+#include "ConcurrentQueue.h"
+#include "IntrusiveList.h"
 #include <cassert>
 #include <iterator>
+#include <string>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <cstdio>
+#include <limits>
 
 // 测试默认构造函数
+template <template <typename> class L>
 void testDefaultConstructor() {
-    List<int> list;
+    L<int> list;
     assert(list.size() == 0);
     assert(list.empty());
     list.printList();   // expect empty line
 }
 
 // 测试初始化列表构造函数
+template <template <typename> class L>
 void testInitializerListConstructor() {
-    List<int> list = {1, 2, 3, 4, 5};
+    L<int> list = {1, 2, 3, 4, 5};
     assert(list.size() == 5);
     assert(*(list.begin()) == 1 && *(--list.end()) == 5);
     list.printList();   // expect: 1 2 3 4 5
 }
 
 // 测试拷贝构造函数
+template <template <typename> class L>
 void testCopyConstructor() {
-    List<int> list1 = {1, 2, 3, 4, 5};
-    List<int> list2(list1);
+    L<int> list1 = {1, 2, 3, 4, 5};
+    L<int> list2(list1);
     assert(list2.size() == 5);
     assert(*list2.begin() == 1 && *(--list2.end()) == 5);
     list1.printList();  // expect: 1 2 3 4 5
@@ -29,42 +48,98 @@ void testCopyConstructor() {
 }
 
 // 测试移动构造函数
+template <template <typename> class L>
 void testMoveConstructor() {
-    List<std::string> list1 = {"one", "two", "three"};
-    List<std::string> list2(std::move(list1));
+    L<std::string> list1 = {"one", "two", "three"};
+    L<std::string> list2(std::move(list1));
     assert(list1.size() == 0);
     assert(list2.size() == 3);
     assert(*list2.begin() == "one" && *(--list2.end()) == "three");
-    // list1.printList(); 尝试访问会导致程序崩溃，因为 head 和 tail 都被指向 nullptr 而不是一个有效的节点
+    list1.printList();  // expect empty line. 被移动后的表是一张合法的空表
     list2.printList();  // expect: one two three
+    list1.push_back("four");
+    assert(list1.size() == 1 && list1.front() == "four");
 }
 
 // 测试赋值运算符
+template <template <typename> class L>
 void testAssignmentOperator() {
-    List<int> list1 = {1, 2, 3, 4, 5};
-    List<int> list2;
+    L<int> list1 = {1, 2, 3, 4, 5};
+    L<int> list2;
     list2 = list1;
     assert(list2.size() == 5);
     assert(*list2.begin() == 1 && *(--list2.end()) == 5);
     list1.printList();  // expect: 1 2 3 4 5
     list2.printList();  // expect: 1 2 3 4 5
+
+    // 赋值直接复用已有的节点, 多删少补
+    L<std::string> a = {"one", "two", "three"};
+    L<std::string> b = {"x", "y"};
+    auto first = a.begin();
+    a = b;
+    assert(a.size() == 2 && *first == "x" && a.back() == "y");
+    assert(first == a.begin());     // 第一个节点还是原来的节点
+    b = {"1", "2", "3", "4", "5"};
+    a = b;
+    assert(a.size() == 5 && *first == "1" && a.back() == "5");
+    assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+    b = L<std::string>();
+    a = b;
+    assert(a.empty() && a.begin() == a.end());
+    a = a;
+    assert(a.empty());
 }
 
 // 测试移动赋值运算符
+template <template <typename> class L>
 void testMoveAssignmentOperator() {
-    List<std::string> list1 = {"one", "two", "three"};
-    List<std::string> list2;
+    L<std::string> list1 = {"one", "two", "three"};
+    L<std::string> list2;
     list2 = std::move(list1);
     assert(list1.size() == 0);
     assert(list2.size() == 3);
     assert(*list2.begin() == "one" && *(--list2.end()) == "three");
-    // list1.printList();
+    list1.printList();  // expect empty line
     list2.printList();  // expect: one two three
+    list1 = {"a", "b"};
+    list2 = std::move(list1);
+    assert(list1.empty() && list2.size() == 2 && list2.back() == "b");
+    list2 = std::move(list2);   // 自我移动赋值不改变内容
+    assert(list2.size() == 2);
+}
+
+// 测试 swap
+template <template <typename> class L>
+void testSwap() {
+    L<std::string> a = {"1", "2", "3", "4", "5", "6"};
+    L<std::string> b = {"x"};
+    a.swap(b);
+    assert(a.size() == 1 && a.front() == "x");
+    assert(b.size() == 6 && b.front() == "1" && b.back() == "6");
+    using std::swap;
+    swap(a, b);     // 通过 ADL 找到 List 的 swap
+    assert(a.size() == 6 && b.size() == 1);
+    std::swap(a, b);
+    assert(a.size() == 1 && b.size() == 6);
+    a.swap(a);
+    assert(a.size() == 1);
+
+    // vector 扩容时移动而不是拷贝
+    static_assert(std::is_nothrow_move_constructible<L<std::string>>::value);
+    static_assert(std::is_nothrow_move_assignable<L<std::string>>::value);
+    static_assert(std::is_nothrow_swappable<L<std::string>>::value);
+    std::vector<L<std::string>> v;
+    v.emplace_back(b);
+    const std::string *first = &v[0].back();
+    for (int i = 0; i < 100; ++i)
+        v.emplace_back();
+    assert(v[0].size() == 6 && &v[0].back() == first);
 }
 
 // 测试插入和删除函数
+template <template <typename> class L>
 void testInsertAndErase() {
-    List<int> list = {4, 5, 6};
+    L<int> list = {4, 5, 6};
     
     // 插入元素
     list.insert(list.end(), 1);
@@ -102,8 +177,9 @@ void testInsertAndErase() {
 }
 
 // 测试push和pop函数
+template <template <typename> class L>
 void testPushAndPop() {
-    List<float> list = {0.1, 0.2, 0.3, 0.4};
+    L<float> list = {0.1, 0.2, 0.3, 0.4};
 
     // 插入数据到list头部
     list.push_front(-0.1);
@@ -130,8 +206,9 @@ void testPushAndPop() {
 }
 
 // 测试迭代器
+template <template <typename> class L>
 void testIterators() {
-    List<int> list = {1, 2, 3, 4, 5};
+    L<int> list = {1, 2, 3, 4, 5};
 
     // 测试 iterator
     auto it = list.begin();
@@ -151,27 +228,28 @@ void testIterators() {
 
     // 测试 const_iterator
     // 使用const_iterator遍历List
-    for (List<int>::const_iterator c_it = list.begin(); c_it != list.end(); ++c_it) {
+    for (typename L<int>::const_iterator c_it = list.begin(); c_it != list.end(); ++c_it) {
         std::cout << *c_it << " "; 
     }
     std::cout << std::endl;     // expect: 1 2 3 4 5
     
     // 使用const_iterator验证特定值
-    List<int>::const_iterator c_cit = --list.end();
+    typename L<int>::const_iterator c_cit = --list.end();
     for (int i = 5; i > 0; --i, --c_cit) {
         assert(*c_cit == i); // 再次使用operator*来获取当前节点的数据
     }
 
     // 测试返回值为 const 的情况
-    const List<int>& constList = list;
+    const L<int>& constList = list;
     assert(constList.front() == 1);
     assert(constList.back() == 5);
 
 }
 
 // 测试边界条件
+template <template <typename> class L>
 void testBoundaryConditions() {
-    List<int> list;
+    L<int> list;
     assert(list.size() == 0);
     assert(list.empty());
     list.push_back(1);
@@ -189,6 +267,968 @@ void testBoundaryConditions() {
     assert(list.back() == 1);
 }
 
+// 测试节点分配策略
+void testAllocatorPolicy() {
+    // 全局 new 的版本行为应当完全一致
+    List<int, NewAllocator> plain = {1, 2, 3};
+    plain.push_front(0);
+    plain.erase(++plain.begin());
+    assert(plain.size() == 3);
+    assert(plain.front() == 0 && plain.back() == 3);
+    plain.clear();
+    assert(plain.empty());
+    plain.push_back(7);
+    assert(plain.front() == 7);
+
+    // 内存池: 删除后的节点应当被复用，clear 之后仍可正常使用
+    List<std::string> pooled;
+    for (int i = 0; i < 100; ++i)
+        pooled.push_back(std::to_string(i));
+    for (int i = 0; i < 50; ++i)
+        pooled.pop_front();
+    for (int i = 0; i < 50; ++i)
+        pooled.push_front(std::to_string(i));
+    assert(pooled.size() == 100);
+    assert(pooled.front() == "49" && pooled.back() == "99");
+    pooled.clear();
+    assert(pooled.empty());
+    pooled.push_back("again");
+    assert(pooled.size() == 1 && pooled.front() == "again");
+
+    // 拷贝赋值直接给已有的节点赋值，多出来的节点还给自己的内存池，两张表的内存池互不相干
+    List<std::string> other = {"a", "b"};
+    const std::string *firstNode = &other.front();
+    other = pooled;
+    pooled.clear();
+    assert(other.size() == 1 && other.front() == "again");
+    assert(&other.front() == firstNode);
+}
+
+// 测试整段删除和整体清空
+void testBulkErase() {
+    // 可平凡析构的元素: 整段挂回内存池，之后的插入复用这些节点
+    List<int> ints;
+    for (int i = 0; i < 10; ++i)
+        ints.push_back(i);
+    auto from = ints.begin();
+    auto to = ints.begin();
+    for (int i = 0; i < 2; ++i) ++from;
+    for (int i = 0; i < 8; ++i) ++to;
+    auto ret = ints.erase(from, to);
+    assert(ints.size() == 4);
+    assert(*ret == 8);
+    ints.printList();   // expect: 0 1 8 9
+    for (int i = 0; i < 6; ++i)
+        ints.insert(ret, 100 + i);
+    assert(ints.size() == 10);
+    ints.printList();   // expect: 0 1 100 101 102 103 104 105 8 9
+    ints.erase(ints.begin(), ints.end());
+    assert(ints.empty());
+    ints.push_back(42);
+    assert(ints.front() == 42 && ints.back() == 42);
+
+    // 需要析构的元素走逐个析构的路径
+    List<std::string> strs = {"a", "b", "c", "d"};
+    strs.erase(++strs.begin(), --strs.end());
+    assert(strs.size() == 2);
+    assert(strs.front() == "a" && strs.back() == "d");
+
+    // 全局 new 的版本
+    List<int, NewAllocator> plain = {1, 2, 3, 4, 5};
+    plain.erase(++plain.begin(), --plain.end());
+    assert(plain.size() == 2 && plain.front() == 1 && plain.back() == 5);
+    plain.clear();
+    assert(plain.empty());
+}
+
+// 记录移动次数的元素
+struct Moves {
+    static int count;
+    int v;
+    Moves(int x) : v(x) {}
+    Moves(const Moves &) = default;
+    Moves(Moves &&rhs) noexcept : v(rhs.v) { ++count; }
+    Moves &operator=(const Moves &) = default;
+    Moves &operator=(Moves &&rhs) noexcept { v = rhs.v; ++count; return *this; }
+};
+int Moves::count = 0;
+
+// 测试 splice, merge 和 sort
+void testSpliceMergeSort() {
+    // 整表 splice: 内存池被整体接管，other 变为空表后仍可使用
+    List<int> a = {1, 2, 3};
+    List<int> b = {10, 20};
+    auto it10 = b.begin();
+    a.splice(++a.begin(), b);
+    assert(a.size() == 5 && b.empty());
+    assert(*it10 == 10);
+    a.printList();      // expect: 1 10 20 2 3
+    b.push_back(99);
+    assert(b.size() == 1 && b.front() == 99);
+
+    // 同一张表内移动一个元素和一段元素
+    a.splice(a.end(), a, a.begin());
+    a.printList();      // expect: 10 20 2 3 1
+    a.splice(a.begin(), a, --(--a.end()), a.end());
+    assert(a.size() == 5);
+    a.printList();      // expect: 3 1 10 20 2
+
+    // 跨表移动一段: 全局 new 的节点可以直接换主人，NodePool 的元素被移动过来
+    List<int, NewAllocator> c = {1, 2, 3, 4};
+    List<int, NewAllocator> d = {9};
+    d.splice(d.begin(), c, ++c.begin(), c.end());
+    assert(c.size() == 1 && d.size() == 4);
+    d.printList();      // expect: 2 3 4 9
+    List<std::string> f;
+    {
+        List<std::string> e = {"x", "y", "z"};
+        f.splice(f.end(), e, ++e.begin());
+        assert(e.size() == 2 && f.size() == 1 && f.front() == "y");
+        e.push_back("w");
+        f.splice(f.begin(), e, e.begin(), --e.end());
+        assert(e.size() == 1 && e.front() == "w");
+    }
+    // 元素搬进了 f 自己的内存池，e 析构之后仍然可用
+    assert(f.size() == 3);
+    f.printList();      // expect: x z y
+    f.erase(f.begin());
+    f.push_back("v");
+    f.printList();      // expect: z y v
+
+    // 排序之后原来的迭代器仍然指向原来的元素
+    List<int> g = {5, 3, 9, 1, 7, 3, 8, 2, 6, 4, 0};
+    auto it9 = g.begin();
+    ++it9; ++it9;
+    g.sort();
+    assert(*it9 == 9 && it9 == --g.end());
+    assert(g.size() == 11);
+    g.printList();      // expect: 0 1 2 3 3 4 5 6 7 8 9
+    int prev = -1;
+    for (int x : g) { assert(prev <= x); prev = x; }
+    g.sort(std::greater<int>());
+    assert(g.front() == 9 && g.back() == 0);
+
+    // 稳定性: 只比较 first
+    List<std::pair<int, int>> h;
+    for (int i = 0; i < 100; ++i)
+        h.push_back({(i * 37) % 5, i});
+    h.sort([](const std::pair<int, int> &x, const std::pair<int, int> &y) { return x.first < y.first; });
+    auto p = h.begin();
+    for (auto q = p++; p != h.end(); q = p++)
+        assert((*q).first < (*p).first || ((*q).first == (*p).first && (*q).second < (*p).second));
+
+    // 归并两张有序表
+    List<int> m1 = {1, 4, 6, 10};
+    List<int> m2 = {2, 4, 5, 11, 12};
+    m1.merge(m2);
+    assert(m1.size() == 9 && m2.empty());
+    m1.printList();     // expect: 1 2 4 4 5 6 10 11 12
+
+    // 比较函数抛出异常: 元素一个不少, 两个方向都能走完, 表之后仍然可用
+    auto intact = [](List<std::string> &l, std::vector<std::string> expected) {
+        std::vector<std::string> seen(l.begin(), l.end()), back;
+        for (auto it = l.end(); it != l.begin(); )
+            back.push_back(*--it);
+        assert((int)seen.size() == l.size());
+        std::reverse(back.begin(), back.end());
+        assert(seen == back);
+        std::sort(seen.begin(), seen.end());
+        std::sort(expected.begin(), expected.end());
+        assert(seen == expected);
+    };
+    std::vector<std::string> all = {"k", "c", "x", "a", "q", "e", "m", "b", "z", "d", "h"};
+    for (int limit = 0; limit < 40; ++limit) {
+        int calls = 0;
+        auto comp = [&calls, limit](const std::string &x, const std::string &y) {
+            if (calls++ == limit)
+                throw std::runtime_error("comp");
+            return x < y;
+        };
+        List<std::string> s1;
+        for (const std::string &x : all)
+            s1.push_back(x);
+        try { s1.sort(comp); } catch (const std::runtime_error &) { }
+        intact(s1, all);
+        s1.sort();
+        assert(std::is_sorted(s1.begin(), s1.end()));
+
+        calls = 0;
+        List<std::string> m3 = {"b", "d", "f", "h"};
+        List<std::string> m4 = {"a", "c", "e", "g", "i"};
+        try { m3.merge(m4, comp); } catch (const std::runtime_error &) { }
+        intact(m3, {"a", "b", "c", "d", "e", "f", "g", "h", "i"});
+        assert(m4.empty());
+        m4.push_back("j");
+        m3.sort();
+        m3.merge(m4);
+        assert(m3.size() == 10 && m3.back() == "j");
+    }
+}
+
+/**
+ * @brief 用当前 CPU 支持的每一种指令集, 在各种长度和起点 (对齐与否) 的数组里查找每一个位置,
+ * 结果都要和 std::find 一致.
+ */
+template <typename T>
+void checkSimdFind() {
+    T data[80];
+    for (int i = 0; i < 80; ++i)
+        data[i] = static_cast<T>(i + 1);
+    for (int lv = 0; lv <= (int)SimdFind::level(); ++lv) {
+        auto level = (SimdFind::Level)lv;
+        for (int offset = 0; offset < 3; ++offset)
+            for (int n = 0; n + offset <= 80; ++n) {
+                const T *first = data + offset, *last = first + n;
+                for (int k = 0; k <= n + 1; ++k) {
+                    T x = static_cast<T>(offset + k + 1);
+                    assert(SimdFind::find(first, last, x, level) == std::find(first, last, x));
+                }
+            }
+    }
+}
+
+// 测试向量化的查找
+void testSimdFind() {
+    checkSimdFind<int>();
+    checkSimdFind<unsigned>();
+    checkSimdFind<long long>();
+    checkSimdFind<float>();
+    checkSimdFind<double>();
+    checkSimdFind<short>();     // 没有向量版本, 逐个比较
+
+    // 重复元素返回第一个; 浮点数的比较和 == 一致
+    double d[9] = {1, 2, -0.0, 4, 5, 6, 7, 2, 0.0};
+    for (int lv = 0; lv <= (int)SimdFind::level(); ++lv) {
+        auto level = (SimdFind::Level)lv;
+        assert(SimdFind::find(d, d + 9, 2.0, level) == d + 1);
+        assert(SimdFind::find(d, d + 9, 0.0, level) == d + 2);
+        d[4] = std::numeric_limits<double>::quiet_NaN();
+        assert(SimdFind::find(d, d + 9, d[4], level) == d + 9);
+    }
+
+    UnrolledList<int, 8> list;
+    for (int i = 0; i < 100; ++i)
+        list.push_back(i);
+    for (int i = 0; i < 100; i += 7) {
+        auto it = list.find(i);
+        assert(it != list.end() && *it == i);
+        assert(std::distance(list.begin(), it) == i);
+    }
+    assert(list.find(100) == list.end());
+    const UnrolledList<std::string, 4> words = {"a", "b", "c", "d", "e"};
+    assert(*words.find("d") == "d" && words.find("z") == words.end());
+}
+
+// 测试展开链表
+void testUnrolledList() {
+    UnrolledList<int, 4> list = {1, 2, 3, 4, 5};
+    assert(list.size() == 5);
+    assert(list.front() == 1 && list.back() == 5);
+    list.printList();   // expect: 1 2 3 4 5
+
+    // 在满块中间插入，触发分裂
+    auto it = list.begin();
+    ++it; ++it;
+    it = list.insert(it, 100);
+    assert(*it == 100 && list.size() == 6);
+    list.push_front(0);
+    list.push_back(6);
+    list.printList();   // expect: 0 1 2 100 3 4 5 6
+
+    // 正向和反向遍历的结果一致
+    int expect[] = {0, 1, 2, 100, 3, 4, 5, 6};
+    int k = 0;
+    for (int x : list)
+        assert(x == expect[k++]);
+    auto rit = list.end();
+    while (k > 0)
+        assert(*--rit == expect[--k]);
+
+    // 删除，触发合并
+    it = list.begin();
+    ++it; ++it; ++it;
+    it = list.erase(it);
+    assert(*it == 3);
+    list.pop_front();
+    list.pop_back();
+    assert(list.size() == 5);
+    list.printList();   // expect: 1 2 3 4 5
+    it = list.erase(++list.begin(), --list.end());
+    assert(*it == 5 && list.size() == 2);
+
+    // 大量随机位置的插入删除，与 List 对照
+    UnrolledList<std::string, 8> u;
+    List<std::string> l;
+    unsigned seed = 12345;
+    for (int round = 0; round < 2000; ++round) {
+        seed = seed * 1103515245 + 12345;
+        int pos = l.empty() ? 0 : (seed >> 8) % (l.size() + 1);
+        auto ui = u.begin();
+        auto li = l.begin();
+        for (int i = 0; i < pos; ++i) { ++ui; ++li; }
+        if ((seed >> 4) % 3 != 0 || l.empty()) {
+            u.insert(ui, std::to_string(round));
+            l.insert(li, std::to_string(round));
+        } else if (li != l.end()) {
+            u.erase(ui);
+            l.erase(li);
+        }
+    }
+    assert(u.size() == l.size());
+    auto li = l.begin();
+    for (auto ui = u.begin(); ui != u.end(); ++ui, ++li)
+        assert(*ui == *li);
+
+    // 拷贝、移动和清空
+    UnrolledList<std::string, 8> copy = u;
+    UnrolledList<std::string, 8> moved = std::move(u);
+    assert(u.empty() && moved.size() == copy.size());
+    u.push_back("reuse");
+    assert(u.size() == 1 && u.front() == "reuse");
+    copy = u;
+    assert(copy.size() == 1);
+    moved.clear();
+    assert(moved.empty() && moved.begin() == moved.end());
+
+    // 插入表中已有元素的引用: 后移和分裂都会改写那个位置, 插入的必须是原来的值
+    UnrolledList<std::string, 4> alias = {"element-number-0", "element-number-1", "element-number-2"};
+    auto third = alias.begin();
+    ++third; ++third;
+    alias.insert(alias.begin(), *third);
+    assert(alias.front() == "element-number-2" && alias.size() == 4);
+    auto last = --alias.end();
+    alias.insert(alias.begin(), *last);     // 块已满, 先分裂, last 所在的元素被搬到新块
+    assert(alias.front() == "element-number-2" && alias.size() == 5);
+    const char *order[] = {"element-number-2", "element-number-2", "element-number-0",
+                           "element-number-1", "element-number-2"};
+    k = 0;
+    for (const std::string &s : alias)
+        assert(s == order[k++]);
+
+    // 不可能是表中元素的值直接放进去, 没有多余的临时对象
+    UnrolledList<Moves, 4> direct;
+    Moves::count = 0;
+    direct.push_back(Moves{1});
+    const Moves outside{2};
+    direct.push_back(outside);
+    assert(Moves::count == 1);
+    direct.insert(direct.begin(), Moves{0});
+    assert(Moves::count == 1 + 2 + 1 && direct.size() == 3);   // 后移两个元素, 再把新元素移进去
+    direct.insert(direct.begin(), direct.back());
+    assert(direct.front().v == 2 && direct.size() == 4);
+}
+
+// 一个没有默认构造函数、并记录拷贝和移动次数的类型
+struct Tracked {
+    static int copies;
+    static int moves;
+    std::string name;
+    int id;
+    Tracked(const std::string &a, const std::string &b, int i) : name(a + b), id(i) {}
+    Tracked(const Tracked &rhs) : name(rhs.name), id(rhs.id) { ++copies; }
+    Tracked(Tracked &&rhs) noexcept : name(std::move(rhs.name)), id(rhs.id) { ++moves; }
+};
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+std::ostream &operator<<(std::ostream &os, const Tracked &t) {
+    return os << t.name << '#' << t.id;
+}
+
+// 测试就地构造
+template <template <typename> class L>
+void testEmplace() {
+    // Tracked 没有默认构造函数，哨兵不再需要构造 Object{}
+    L<Tracked> list;
+    assert(list.empty());
+    Tracked::copies = Tracked::moves = 0;
+    list.emplace_back("ab", "c", 1);
+    list.emplace_front("x", "y", 0);
+    auto it = list.emplace(--list.end(), "mid", "dle", 5);
+    Tracked &last = list.emplace_back("e", "nd", 9);
+    assert(Tracked::copies == 0 && Tracked::moves == 0);
+    assert(list.size() == 4);
+    assert((*it).name == "middle" && (*it).id == 5);
+    assert(last.name == "end" && &last == &list.back());
+    assert(list.front().name == "xy");
+
+    // 普通的 push 仍然是一次拷贝或一次移动
+    Tracked t("t", "", 7);
+    list.push_back(t);
+    list.push_back(std::move(t));
+    assert(Tracked::copies == 1 && Tracked::moves == 1);
+
+    // 移动构造之后，原表是合法的空表
+    L<Tracked> other(std::move(list));
+    assert(other.size() == 6 && list.empty());
+    assert(other.front().name == "xy");
+    list.emplace_back("new", "", 1);
+    assert(list.size() == 1);
+}
+
+#ifdef __cpp_lib_concepts
+// List 的迭代器满足 C++20 的双向迭代器概念
+static_assert(std::bidirectional_iterator<List<int>::iterator>);
+static_assert(std::bidirectional_iterator<List<int>::const_iterator>);
+static_assert(std::bidirectional_iterator<UnrolledList<int>::iterator>);
+static_assert(std::ranges::bidirectional_range<List<std::string>>);
+static_assert(std::output_iterator<List<int>::iterator, int>);
+#endif
+
+// 测试标准库算法在 List 上的使用
+template <template <typename> class L>
+void testStdAlgorithms() {
+    L<int> list = {5, 3, 8, 1, 9, 2};
+    assert(std::distance(list.begin(), list.end()) == 6);
+    auto it = list.begin();
+    std::advance(it, 2);
+    assert(*it == 8);
+    assert(*std::next(it) == 1 && *std::prev(it) == 3);
+    assert(*std::find_if(list.begin(), list.end(), [](int x) { return x > 8; }) == 9);
+    assert(std::count_if(list.begin(), list.end(), [](int x) { return x % 2 == 1; }) == 4);
+    assert(std::accumulate(list.begin(), list.end(), 0) == 28);
+    assert(*std::max_element(list.begin(), list.end()) == 9);
+    std::reverse(list.begin(), list.end());
+    list.printList();   // expect: 2 9 1 8 3 5
+    std::vector<int> v(list.rbegin(), list.rend());
+    assert((v == std::vector<int>{5, 3, 8, 1, 9, 2}));
+    std::transform(list.begin(), list.end(), list.begin(), [](int x) { return x * 10; });
+    assert(list.front() == 20 && list.back() == 50);
+    std::fill(list.begin(), list.end(), 7);
+    assert(std::all_of(list.cbegin(), list.cend(), [](int x) { return x == 7; }));
+
+    // 反向迭代器和 ->
+    L<std::string> words = {"alpha", "beta", "gamma"};
+    auto rit = words.rbegin();
+    assert(*rit == "gamma" && rit->size() == 5);
+    ++rit;
+    assert(*rit == "beta");
+    const L<std::string> &cw = words;
+    assert(cw.rbegin()->front() == 'g' && *--cw.rend() == "alpha");
+    assert(words.begin()->length() == 5);
+    words.begin()->append("!");
+    assert(words.front() == "alpha!");
+    assert(std::equal(words.begin(), words.end(), std::vector<std::string>{"alpha!", "beta", "gamma"}.begin()));
+
+#ifdef __cpp_lib_ranges
+    assert(std::ranges::distance(words) == 3);
+    assert(std::ranges::find(words, "beta") != words.end());
+#endif
+}
+
+/**
+ * @brief 在 List 和 std::list 上分别运行同样的算法并计时.
+ * 
+ * @param name 算法的名字.
+ * @param f 接受一个容器的函数.
+ */
+template <typename F>
+void compareWithStdList(const char *name, F f) {
+    const int n = 200000;
+    List<int> mine;
+    std::list<int> theirs;
+    for (int i = 0; i < n; ++i) {
+        int x = (i * 7919) % n;
+        mine.push_back(x);
+        theirs.push_back(x);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    long long a = f(mine);
+    auto mid = std::chrono::high_resolution_clock::now();
+    long long b = f(theirs);
+    auto end = std::chrono::high_resolution_clock::now();
+    assert(a == b);
+    std::chrono::duration<double, std::milli> t1 = mid - start, t2 = end - mid;
+    std::cout << name << ": List " << t1.count() << " ms, std::list " << t2.count() << " ms" << std::endl;
+}
+
+// 与 std::list 比较算法的速度
+void testStdAlgorithmsSpeed() {
+    compareWithStdList("accumulate", [](auto &c) {
+        return std::accumulate(c.begin(), c.end(), 0LL);
+    });
+    compareWithStdList("find_if", [](auto &c) {
+        return (long long)*std::find_if(c.begin(), c.end(), [](int x) { return x == 199999; });
+    });
+    compareWithStdList("distance", [](auto &c) {
+        return (long long)std::distance(c.begin(), c.end());
+    });
+    compareWithStdList("reverse", [](auto &c) {
+        std::reverse(c.begin(), c.end());
+        return (long long)*c.begin();
+    });
+    compareWithStdList("sort", [](auto &c) {
+        c.sort();
+        return (long long)*c.rbegin();
+    });
+}
+
+// 测试无锁队列: 单线程的先进先出, 以及多个生产者和消费者同时读写
+void testConcurrentQueue() {
+    {
+        ConcurrentQueue<std::string> q;
+        std::string s;
+        assert(q.empty() && !q.try_pop(s));
+        q.push("one");
+        q.emplace(3, 'x');
+        assert(q.try_pop(s) && s == "one");
+        assert(q.try_pop(s) && s == "xxx");
+        assert(!q.try_pop(s));
+        q.push("left in queue");    // 由析构函数释放
+    }
+
+    const int producers = 4, consumers = 4, perProducer = 20000;
+    ConcurrentQueue<std::pair<int, int>> q;
+    std::atomic<int> popped{0};
+    std::vector<std::vector<int>> seen(consumers, std::vector<int>(producers * perProducer, 0));
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&q, p] {
+            for (int i = 0; i < perProducer; ++i)
+                q.push({p, i});
+        });
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&, c] {
+            std::vector<int> last(producers, -1);
+            std::pair<int, int> x;
+            while (popped.load() < producers * perProducer) {
+                if (!q.try_pop(x))
+                    continue;
+                popped.fetch_add(1);
+                // 同一个生产者的元素, 被同一个消费者取出时必须保持入队的顺序
+                assert(x.second > last[x.first]);
+                last[x.first] = x.second;
+                seen[c][x.first * perProducer + x.second]++;
+            }
+        });
+    for (auto &t : threads)
+        t.join();
+
+    // 每个元素恰好被取出一次
+    for (int k = 0; k < producers * perProducer; ++k) {
+        int times = 0;
+        for (int c = 0; c < consumers; ++c)
+            times += seen[c][k];
+        assert(times == 1);
+    }
+    assert(q.empty());
+}
+
+/// 只有 4 个内联节点的 SmallList, 使上面的测试既覆盖内联节点也覆盖溢出到堆上的节点.
+template <typename Object>
+using Small = SmallList<Object, 4>;
+
+/**
+ * @brief 判断 p 是否位于对象 obj 的内部.
+ */
+template <typename T>
+bool insideObject(const T &obj, const void *p) {
+    auto begin = reinterpret_cast<const char *>(&obj);
+    auto x = reinterpret_cast<const char *>(p);
+    return std::less_equal<const char *>()(begin, x) && std::less<const char *>()(x, begin + sizeof(T));
+}
+
+// 测试短表优化
+void testSmallList() {
+    // 不超过 N 个元素时, 所有节点都在对象内部
+    Small<int> list = {1, 2, 3, 4};
+    for (auto &x : list)
+        assert(insideObject(list, &x));
+    list.push_back(5);
+    assert(!insideObject(list, &list.back()));
+
+    // 移动时堆上的节点原样接管, 内联节点搬到新对象内部
+    Small<int> big;
+    for (int i = 0; i < 20; ++i)
+        big.push_back(i);
+    const int *spilled = &*std::next(big.begin(), 10);
+    Small<int> moved(std::move(big));
+    assert(big.empty() && moved.size() == 20);
+    assert(&*std::next(moved.begin(), 10) == spilled);
+    int i = 0;
+    for (auto &x : moved) {
+        assert(x == i++);
+        if (i <= 4)
+            assert(insideObject(moved, &x));
+    }
+    big.push_back(42);
+    assert(big.front() == 42 && insideObject(big, &big.front()));
+
+    // 删掉前面的元素后, 内联的空位会被重新利用
+    moved.erase(moved.begin(), std::next(moved.begin(), 2));
+    moved.push_front(-1);
+    assert(insideObject(moved, &moved.front()));
+
+    // 整表 splice 和移动赋值
+    Small<std::string> a = {"a", "b"}, b = {"c", "d", "e", "f", "g"};
+    a.splice(a.end(), b);
+    assert(b.empty() && a.size() == 7 && a.back() == "g");
+    assert(std::equal(a.begin(), a.end(), std::vector<std::string>{"a", "b", "c", "d", "e", "f", "g"}.begin()));
+    b = std::move(a);
+    assert(a.empty() && b.size() == 7 && b.front() == "a");
+    a = b;
+    assert(a.size() == 7 && a.back() == "g");
+    a.sort(std::greater<std::string>());
+    assert(a.front() == "g" && a.back() == "a");
+}
+
+/**
+ * @brief 依次运行基本功能的测试.
+ */
+template <template <typename> class L>
+void testBasics() {
+    testDefaultConstructor<L>();
+    testInitializerListConstructor<L>();
+    testCopyConstructor<L>();
+    testMoveConstructor<L>();
+    testAssignmentOperator<L>();
+    testMoveAssignmentOperator<L>();
+    testSwap<L>();
+    testInsertAndErase<L>();
+    testPushAndPop<L>();
+    testIterators<L>();
+    testBoundaryConditions<L>();
+    testEmplace<L>();
+    testStdAlgorithms<L>();
+}
+
+/**
+ * @brief 检查 list 的内容与 v 一致, 并且 at 和 index_of 都正确.
+ */
+template <typename L>
+void checkIndexed(const L &list, const std::vector<int> &v) {
+    assert(list.size() == (int)v.size());
+    int k = 0;
+    for (auto it = list.begin(); it != list.end(); ++it, ++k) {
+        assert(*it == v[k] && list.at(k) == v[k]);
+        assert(list.index_of(it) == k);
+    }
+    assert(list.index_of(list.end()) == list.size());
+}
+
+// 测试按位置访问的索引
+template <template <typename> class Alloc>
+void testIndexedList() {
+    using L = List<int, Alloc, SkipIndex>;
+    L list;
+    std::vector<int> v;
+    unsigned seed = 12345;
+    auto rnd = [&seed](int n) {
+        seed = seed * 1103515245 + 12345;
+        return (int)((seed >> 8) % n);
+    };
+
+    // 随机位置的插入和删除
+    for (int i = 0; i < 2000; ++i) {
+        int k = rnd(v.size() + 1);
+        list.insert(list.advance(list.begin(), k), i);
+        v.insert(v.begin() + k, i);
+        if (i % 3 == 0) {
+            int j = rnd(v.size());
+            list.erase(list.advance(list.end(), j - (int)v.size()));
+            v.erase(v.begin() + j);
+        }
+    }
+    checkIndexed(list, v);
+
+    // 越界
+    bool thrown = false;
+    try { list.at(list.size()); } catch (const std::out_of_range &) { thrown = true; }
+    assert(thrown);
+    thrown = false;
+    try { list.advance(list.begin(), -1); } catch (const std::out_of_range &) { thrown = true; }
+    assert(thrown);
+
+    // 整段删除, 排序, 单个元素的 splice
+    list.erase(list.advance(list.begin(), 100), list.advance(list.begin(), 300));
+    v.erase(v.begin() + 100, v.begin() + 300);
+    checkIndexed(list, v);
+    list.sort();
+    std::sort(v.begin(), v.end());
+    checkIndexed(list, v);
+    list.splice(list.begin(), list, list.advance(list.begin(), 50));
+    std::rotate(v.begin(), v.begin() + 50, v.begin() + 51);
+    checkIndexed(list, v);
+
+    // 跨表的 splice 和 merge
+    L other;
+    std::vector<int> w;
+    for (int i = 0; i < 500; ++i) {
+        other.push_back(2 * i);
+        w.push_back(2 * i);
+    }
+    list.merge(other);
+    std::vector<int> merged;
+    std::merge(v.begin(), v.end(), w.begin(), w.end(), std::back_inserter(merged));
+    v = merged;
+    checkIndexed(list, v);
+    checkIndexed(other, {});
+    other.push_back(-1);
+    other.push_back(-2);
+    list.splice(list.advance(list.begin(), 10), other, other.begin(), other.end());
+    v.insert(v.begin() + 10, {-1, -2});
+    checkIndexed(list, v);
+    list.splice(list.end(), other);
+    other.splice(other.end(), list, list.advance(list.begin(), 5), list.advance(list.begin(), 8));
+    std::vector<int> moved(v.begin() + 5, v.begin() + 8);
+    v.erase(v.begin() + 5, v.begin() + 8);
+    checkIndexed(list, v);
+    checkIndexed(other, moved);
+
+    // 移动, 交换, 拷贝
+    L taken(std::move(list));
+    checkIndexed(taken, v);
+    checkIndexed(list, {});
+    list.push_back(7);
+    taken.swap(list);
+    checkIndexed(list, v);
+    checkIndexed(taken, {7});
+    taken = list;
+    checkIndexed(taken, v);
+    L copy(taken);
+    checkIndexed(copy, v);
+    copy = other;               // 变短: 复用前面的节点, 删掉多出的
+    checkIndexed(copy, moved);
+    copy = taken;               // 变长: 在尾部补齐
+    checkIndexed(copy, v);
+    taken.clear();
+    taken.push_front(1);
+    checkIndexed(taken, {1});
+}
+
+// 测试带缓冲的输出
+void testWriteTo() {
+    List<int> ints = {1, -20, 300};
+    std::ostringstream os;
+    ints.write_to(os);
+    assert(os.str() == "1 -20 300\n");
+
+    // 自定义分隔符和结尾, 浮点数和字符串
+    os.str("");
+    List<double> ds = {0.5, -1.25, 3};
+    ds.write_to(os, {", ", "]\n"});
+    List<std::string> words = {"alpha", "beta"};
+    words.write_to(os, {"|", ""});
+    List<int>().write_to(os, {",", "<empty>"});
+    assert(os.str() == "0.5, -1.25, 3]\nalpha|beta<empty>");
+
+    // 没有 to_chars 的类型退回到 operator<<
+    os.str("");
+    List<Tracked> tracked;
+    tracked.emplace_back("a", "b", 1);
+    tracked.emplace_back("c", "", 2);
+    tracked.write_to(os, {";", "\n"});
+    assert(os.str() == "ab#1;c#2\n");
+
+    // signed char 和 unsigned char 与 printList 一样按字符写出
+    os.str("");
+    List<signed char> sc = {'a', 'b'};
+    List<unsigned char> uc = {'c', 'd'};
+    sc.write_to(os, {"", ""});
+    uc.write_to(os);
+    std::ostringstream expectedChars;
+    expectedChars << sc.front() << sc.back() << uc.front() << ' ' << uc.back() << '\n';
+    assert(os.str() == "abc d\n" && os.str() == expectedChars.str());
+
+    // 很小的缓冲区, 多张表写到同一个缓冲区
+    os.str("");
+    {
+        OutputBuffer out(os, 8);
+        List<int> big;
+        for (int i = 0; i < 1000; ++i)
+            big.push_back(i);
+        big.write_to(out, {"", ""});
+        ints.write_to(out, {",", "."});
+    }
+    std::string expected;
+    for (int i = 0; i < 1000; ++i)
+        expected += std::to_string(i);
+    assert(os.str() == expected + "1,-20,300.");
+
+    // 二进制模式
+    os.str("");
+    ints.write_to(os, {"", "", true});
+    std::string bytes = os.str();
+    assert(bytes.size() == 3 * sizeof(int));
+    int back[3];
+    std::memcpy(back, bytes.data(), bytes.size());
+    assert(back[0] == 1 && back[1] == -20 && back[2] == 300);
+    bool thrown = false;
+    try { words.write_to(os, {"", "", true}); } catch (const std::invalid_argument &) { thrown = true; }
+    assert(thrown);
+}
+
+/// 快照测试用的可平凡拷贝类型, 对齐要求比文件头的大小更严格.
+struct alignas(16) Sample {
+    int id;
+    double value;
+};
+
+// 测试二进制快照
+void testSnapshot() {
+    const char *path = "list_snapshot.tmp";
+    List<int> ints;
+    for (int i = 0; i < 10000; ++i)
+        ints.push_back(i * 31 - 5000);
+    ints.save(path);
+
+    List<int> loaded = {1, 2, 3};
+    loaded.load_mapped(path);
+    assert(loaded.size() == ints.size());
+    assert(std::equal(loaded.begin(), loaded.end(), ints.begin()));
+    // 节点按文件顺序连续排列在同一块内存里
+    const char *prev = reinterpret_cast<const char *>(&loaded.front());
+    std::ptrdiff_t stride = reinterpret_cast<const char *>(&*++loaded.begin()) - prev;
+    for (auto it = ++loaded.begin(); it != loaded.end(); ++it) {
+        const char *p = reinterpret_cast<const char *>(&*it);
+        assert(p - prev == stride);
+        prev = p;
+    }
+    loaded.push_back(7);
+    assert(loaded.back() == 7);
+
+    // 其它类型和其它分配策略
+    List<Sample> samples;
+    for (int i = 0; i < 100; ++i)
+        samples.push_back({i, i * 0.5});
+    samples.save(path);
+    IndexedList<Sample> indexed;
+    indexed.load_mapped(path);
+    assert(indexed.size() == 100 && indexed.at(42).id == 42 && indexed.at(99).value == 49.5);
+    Small<Sample> small;
+    small.load_mapped(path);
+    assert(small.size() == 100 && small.back().id == 99);
+
+    // 空表
+    List<int>().save(path);
+    loaded.load_mapped(path);
+    assert(loaded.empty());
+
+    // 类型不符, 文件被截断, 文件不存在: 抛出异常, 原来的内容不变
+    ints.save(path);
+    bool thrown = false;
+    try { small.load_mapped(path); } catch (const std::runtime_error &) { thrown = true; }
+    assert(thrown && small.size() == 100);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << "x";
+    }
+    loaded.load_mapped(path);   // 多余的字节不影响读取
+    assert(loaded.size() == 10000);
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size() - 100);
+    thrown = false;
+    try { loaded.load_mapped(path); } catch (const std::runtime_error &) { thrown = true; }
+    assert(thrown && loaded.size() == 10000);
+    std::remove(path);
+    thrown = false;
+    try { loaded.load_mapped(path); } catch (const std::runtime_error &) { thrown = true; }
+    assert(thrown);
+}
+
+// 侵入式链表的元素: 同时挂在两张表上, 一个挂钩对应一张表
+struct ByAge {};
+struct Person : IntrusiveHook<>, IntrusiveHook<ByAge> {
+    std::string name;
+    int age;
+    Person(std::string n, int a) : name{std::move(n)}, age{a} {}
+};
+
+std::ostream &operator<<(std::ostream &os, const Person &p) {
+    return os << p.name;
+}
+
+template <typename L>
+std::string names(const L &list) {
+    std::string s;
+    for (const Person &p : list)
+        s += p.name;
+    return s;
+}
+
+void testIntrusiveList() {
+    std::vector<Person> people;
+    for (int i = 0; i < 5; ++i)
+        people.emplace_back(std::string(1, 'a' + i), 50 - i * 10);
+
+    IntrusiveList<Person> list;
+    IntrusiveList<Person, ByAge> byAge;
+    for (auto &p : people) {
+        list.push_back(p);
+        byAge.push_front(p);
+    }
+    assert(list.size() == 5 && byAge.size() == 5);
+    assert(names(list) == "abcde" && names(byAge) == "edcba");
+    // 元素就在 people 里, 表中拿到的是同一个对象
+    assert(&list.front() == &people[0] && &byAge.front() == &people[4]);
+
+    // 只凭引用 O(1) 删除, 另一张表不受影响
+    auto next = list.erase(people[2]);
+    assert(&*next == &people[3]);
+    assert(names(list) == "abde" && names(byAge) == "edcba");
+    assert(!static_cast<IntrusiveHook<> &>(people[2]).is_linked());
+    assert(static_cast<IntrusiveHook<ByAge> &>(people[2]).is_linked());
+
+    // 重新插入, 迭代器可以由元素直接得到
+    list.insert(list.iterator_to(people[1]), people[2]);
+    assert(names(list) == "acbde");
+    bool thrown = false;
+    try { list.push_back(people[2]); } catch (const std::invalid_argument &) { thrown = true; }
+    assert(thrown && list.size() == 5);
+
+    // 双向遍历和标准库算法
+    assert(std::distance(list.begin(), list.end()) == 5);
+    auto it = std::find_if(byAge.begin(), byAge.end(), [](const Person &p) { return p.age == 30; });
+    assert(it != byAge.end() && it->name == "c");
+    int total = std::accumulate(list.begin(), list.end(), 0, [](int s, const Person &p) { return s + p.age; });
+    assert(total == 150);
+    assert((--list.end())->name == "e");
+
+    list.pop_front();
+    list.pop_back();
+    assert(names(list) == "cbd");
+    assert(&list.back() == &people[3]);
+
+    // 拷贝一个元素得到的是不在表中的新对象
+    Person copy = people[1];
+    assert(!static_cast<IntrusiveHook<> &>(copy).is_linked());
+    copy = people[3];
+    list.push_back(copy);
+    assert(names(list) == "cbdd" && list.size() == 4);
+    list.erase(copy);
+
+    // 移动和 splice 只修改首尾的指针
+    IntrusiveList<Person> moved = std::move(list);
+    assert(list.empty() && names(moved) == "cbd");
+    list.push_back(people[0]);
+    list.splice(list.end(), moved);
+    assert(moved.empty() && names(list) == "acbd");
+    moved = std::move(list);
+    assert(list.empty() && moved.size() == 4);
+
+    // clear 和析构只是把元素摘下来
+    moved.clear();
+    for (auto &p : people)
+        assert(!static_cast<IntrusiveHook<> &>(p).is_linked());
+    {
+        IntrusiveList<Person> scoped;
+        scoped.push_back(people[4]);
+    }
+    assert(!static_cast<IntrusiveHook<> &>(people[4]).is_linked());
+    byAge.clear();
+    assert(byAge.empty());
+
+    // 空表
+    thrown = false;
+    try { list.front(); } catch (const std::out_of_range &) { thrown = true; }
+    assert(thrown);
+    list.pop_front();
+    list.pop_back();
+    assert(list.empty());
+}
+
 // bug 复现
 void bug1() {
     List<int> list;
@@ -202,16 +1242,22 @@ void bug2() {
 }
 
 int main() {
-    testDefaultConstructor();
-    testInitializerListConstructor();
-    testCopyConstructor();
-    testMoveConstructor();
-    testAssignmentOperator();
-    testMoveAssignmentOperator();
-    testInsertAndErase();
-    testPushAndPop();
-    testIterators();
-    testBoundaryConditions();
+    testBasics<List>();
+    testBasics<Small>();
+    testAllocatorPolicy();
+    testBulkErase();
+    testSpliceMergeSort();
+    testUnrolledList();
+    testSimdFind();
+    testIntrusiveList();
+    testSmallList();
+    testWriteTo();
+    testSnapshot();
+    testBasics<IndexedList>();
+    testIndexedList<NodePool>();
+    testIndexedList<InlineNodes<4>::template Pool>();
+    testStdAlgorithmsSpeed();
+    testConcurrentQueue();
     std::cout << "All tests passed!" << std::endl;
 
     // bug2();
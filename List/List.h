@@ -4,47 +4,72 @@
 #include <utility>
 #include <initializer_list>
 #include <iostream>
+#include <stdexcept>
+#include <new>
+#include <type_traits>
+#include <functional>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <fstream>
+#include <string>
+#include "NodePool.h"
+#include "SkipIndex.h"
+#include "OutputBuffer.h"
+#include "MappedFile.h"
 
 /**
  * @brief 课本上的 List 实现.
  *
  * @tparam Object List 中的元素类型.
+ * @tparam Allocator 节点的分配策略, 默认为每个 List 私有的 NodePool. 传入 NewAllocator
+ * 则退回到每个节点单独 new / delete 的做法.
+ * @tparam Index 按位置访问的索引策略, 默认的 NoIndex 不占任何空间. 传入 SkipIndex 则
+ * at, index_of 和 advance 都是 O(log n) 的, 插入和删除也变为 O(log n) (见 IndexedList).
  */
-template <typename Object>
+template <typename Object, template <typename> class Allocator = NodePool,
+          template <typename> class Index = NoIndex>
 class List
 {
 private:
+    /**
+     * @brief 节点之间的链接部分. 两个哨兵只需要这一部分，它们不存放数据，
+     * 因此不再需要构造两个 Object{} 的哑元，Object 也不必能够默认构造.
+     */
+    struct NodeBase
+    {
+        NodeBase *prev;  /**<! 指向前一个节点的指针. */
+        NodeBase *next;  /**<! 指向后一个节点的指针. */
+        [[no_unique_address]] typename Index<NodeBase>::Hook hook;  /**<! 索引在节点里存放的数据. */
+    };
+
+    /// 不建索引时，节点和原来一样只有两个指针.
+    static_assert(Index<NodeBase>::enabled || sizeof(NodeBase) == 2 * sizeof(NodeBase *),
+                  "an empty index hook must not enlarge the nodes");
+
     /**
      * @brief 节点的定义. 因为定义的是私有类，所以不需要考虑命名冲突.
      * 外部不会访问到这个类. 因为 struct 默认是 public 的. 所以在
      * List 类内部，Node 类的成员变量和成员函数都是可以直接访问的.
      */
-    struct Node
+    struct Node : NodeBase
     {
         Object data; /**<! 节点内存放的数据. */
-        Node *prev;  /**<! 指向前一个节点的指针. */
-        Node *next;  /**<! 指向后一个节点的指针. */
-        /**
-         * @brief 列表型节点的构造函数. 注意这里的默认参数的使用.
-         * 使我们同时拥有一个默认构造函数和一个带参数的构造函数.
-         *
-         * @param d 节点内存放的数据. 默认为空.
-         * @param p 前一个节点的指针. 默认为空.
-         * @param n 后一个节点的指针. 默认为空.
-         */
-        Node(const Object &d = Object{}, Node *p = nullptr,
-             Node *n = nullptr)
-            : data{d}, prev{p}, next{n} {}
 
         /**
-         * @brief 移动构造函数. 唯一的区别是节点数据是一个右值引用. 因此以 std::move 的方式传递.
+         * @brief 列表型节点的构造函数. args 被原样转发给 Object 的构造函数，
+         * 所以数据直接在节点里构造，不经过临时对象. 原来的左值版本和右值版本
+         * 只是 args 为一个 const Object & 或 Object && 的特例.
          *
-         * @param d 节点内存放的数据. 只有这里是一个显式的右值引用，才会调用这个构造函数.
-         * @param p 前一个节点的指针. 默认为空.
-         * @param n 后一个节点的指针. 默认为空.
+         * @param p 前一个节点的指针.
+         * @param n 后一个节点的指针.
+         * @param args 构造数据所用的参数.
          */
-        Node(Object &&d, Node *p = nullptr, Node *n = nullptr)
-            : data{std::move(d)}, prev{p}, next{n} {}
+        template <typename... Args>
+        Node(NodeBase *p, NodeBase *n, Args &&...args)
+            : NodeBase{p, n}, data(std::forward<Args>(args)...) {}
     };
 
 public:
@@ -56,6 +81,14 @@ public:
     class const_iterator
     {
     public:
+        /// 标准库的算法通过 std::iterator_traits 读取下面这几个类型，从而知道迭代器的能力.
+        /// 链表只能双向逐个移动，所以是双向迭代器.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Object;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Object *;
+        using reference = const Object &;
+
         /**
          * @brief 默认构造函数. 用于初始化迭代器.
          *
@@ -74,6 +107,16 @@ public:
             return retrieve();
         }
 
+        /**
+         * @brief 访问当前节点数据的成员, 即 it->x 等价于 (*it).x.
+         *
+         * @return const Object* 当前节点数据的地址.
+         */
+        const Object *operator->() const
+        {
+            return &retrieve();
+        }
+
         /**
          * @brief 迭代器的前置自增运算符. 用于将迭代器指向下一个节点.
          *
@@ -153,7 +196,7 @@ public:
         /// 在继承中，protected 修饰的成员变量和成员函数，可以被子类访问，但不能被外部访问.
         /// 因此它实际上应该看作是内部的和私有的.
 
-        Node *current; /**<! 当前节点的指针. */
+        NodeBase *current; /**<! 当前节点的指针. */
 
         /**
          * @brief 返回当前节点的数据.
@@ -162,7 +205,7 @@ public:
          */
         Object &retrieve() const
         {
-            return current->data;
+            return static_cast<Node *>(current)->data;
         }
 
         /**
@@ -170,11 +213,11 @@ public:
          *
          * @param p 当前节点的新位置.
          */
-        const_iterator(Node *p) : current{p}
+        const_iterator(NodeBase *p) : current{p}
         {
         }
 
-        friend class List<Object>; /**<! 使 List 类可以访问到迭代器的私有成员和 protected 成员. */
+        friend class List<Object, Allocator, Index>; /**<! 使 List 类可以访问到迭代器的私有成员和 protected 成员. */
 
         /// 注意到 const_iterator 并没有提供析构函数，因为它不需要也不应该释放内存.
     };
@@ -197,29 +240,33 @@ public:
         {
         }
 
+        using pointer = Object *;
+        using reference = Object &;
+
         /**
          * @brief 返回当前节点的数据. 注意这里是可读可写的. 因为它直接调用了父类的 retrieve 函数. 
          * 而父类的 retrieve 函数返回的是一个引用，并没有限制不能修改. 而父类的 retrieve 函数后缀的 const 
          * 只限制了它不能修改父类的成员变量. 因此这里所有的规则都是可以遵守的.
          *
+         * 课本在这里还提供了一个 const 版本返回 const Object &. 但迭代器本身是否为 const
+         * (即能否移动) 与它指向的数据能否修改无关, 就像 int *const p 仍然可以修改 *p.
+         * C++20 的迭代器概念也要求 *it 的类型不随 it 的 const 而变化, 所以这里只保留一个版本.
+         *
          * @return Object& 当前节点的数据.
          */
-        Object &operator*()
+        Object &operator*() const
         {
             return const_iterator::retrieve();
         }
 
         /**
-         * @brief 这其实是一个重载. 一般我们规定重载必须通过参数列表来区分. 
-         * 但通过 return 的 const 修饰符来区分是一个例外. 这使得我们可以给同一个函数分别提供动态和静态的版本，
-         * 然后根据它们的实际使用情况来选择调用哪一个. 注意这里直接调用的父类的对应静态运算. 严格说我们也可以直接调用父类的运算符, 
-         * 但这样会使代码更加清晰.
-         * 
-         * @return const Object& 
+         * @brief 访问当前节点数据的成员. 可读可写.
+         *
+         * @return Object* 当前节点数据的地址.
          */
-        const Object &operator*() const
+        Object *operator->() const
         {
-            return const_iterator::operator*();
+            return &const_iterator::retrieve();
         }
 
         /**
@@ -274,11 +321,11 @@ public:
          *
          * @param p 当前节点的新位置.
          */
-        iterator(Node *p) : const_iterator{p}
+        iterator(NodeBase *p) : const_iterator{p}
         {
         }
 
-        friend class List<Object>;  /**<! 同样使 List 类可以访问到迭代器的私有成员和 protected 成员. */
+        friend class List<Object, Allocator, Index>;  /**<! 同样使 List 类可以访问到迭代器的私有成员和 protected 成员. */
     };
 
 public:
@@ -302,36 +349,39 @@ public:
     /**
      * @brief 拷贝构造函数. 用于将一个 List 的数据拷贝到另一个 List 中.
      * 
+     * 原来的版本对每个元素调用 push_back, 每次都要单独申请一个节点、修改四个指针.
+     * 其实元素个数事先就知道，所以先按 rhs.size() 在内存池中一次预留好所有节点，
+     * 再顺序构造、一趟链好. 新表的节点因此连续排列在同一块内存里.
+     * 
      * @param rhs 右操作对象.
      */
     List(const List &rhs)
     {
         /// 先初始化一个空的 List.
         init( );
-        /// 然后遍历右操作对象，将右操作对象的数据一个一个插入到 List 中.
-        /// 这里的 auto 指针会自行推断类型. 这里的 x 是一个引用，所以不会发生拷贝.
-        /// 而这里的 for 循环的方式实际上让我们可以遍历一个容器，而不需要知道容器的具体类型.
-        /// 也就是说，实际上这里是通过 iterator 来遍历的. 这里的 rhs 是一个 List，所以它有 begin 和 end 函数.
-        /// 这段代码的实际效果等价于
-        ///     for (auto it = rhs.begin(); it != rhs.end(); ++it) {  
-        ///         auto &x = *it;  
-        ///         push_back(x);  
-        ///     }
-        for (auto & x : rhs)
-            /// 调用成员函数从后方（为何）插入到 List 中.
-            push_back(x);
+        pool.reserve( rhs.theSize );
+        /// 构造函数抛出异常时不会调用析构函数，已经拷好的元素要自己析构.
+        try
+        {
+            appendCopies( rhs.begin( ), rhs.theSize );
+        }
+        catch (...)
+        {
+            destroyAll( );
+            throw;
+        }
+        index.rebuild( &head, &tail );
     }
 
     /**
      * @brief 析构函数，用于释放 List 中的内存.
-     * 实际工作是调用 clear 函数，然后释放头尾节点的内存. 别忘了这两个哨兵.
+     * 只需要析构每个数据节点里的元素，节点的内存最终随内存池一起整体释放.
+     * 如果分配策略不支持整体释放，就只能逐个归还了. 哨兵是 List 自身的成员，不用释放.
      * 
      */
     ~List()
     {
-        clear( );
-        delete head;
-        delete tail;
+        destroyAll( );
     }
 
     /// ？？？
@@ -343,46 +393,118 @@ public:
     // }
 
     /**
-     * @brief 赋值运算符. 用于将一个 List 的数据赋值给另一个 List.
-     * 这里采用了 copy-and-swap 的技术. 通过传值的方式来调用拷贝构造函数，
-     * 然后通过 swap 来交换数据. 而 copy 这个临时对象会在函数结束时被销毁.
-     * 这个技术使得整个过程逻辑简单，并且效率更高. 但是一些实现的关键技术细节都是在 
-     * C++ 14 起引入的，因此只实现了 C++ 11 的版本的课本并没有做到.
+     * @brief 拷贝赋值运算符. 用于将一个 List 的数据赋值给另一个 List.
+     * 
+     * 原来的版本采用 copy-and-swap 的技术: 先调用拷贝构造函数得到一个副本，再交换数据，
+     * 原来的节点随副本一起销毁. 这样每次赋值都要把所有节点释放一遍再重新申请一遍.
+     * 现在改为直接在已有的节点上逐个赋值，只有两张表长度不同时才删掉多出的节点，
+     * 或者在尾部一次补齐不够的节点. 元素的拷贝赋值可以复用元素自己的资源 (比如 string 的缓冲区).
+     * 
+     * 代价是中途抛出异常时当前表只保证仍然合法 (已经赋值的元素保留新值)，不再保持原样，
+     * 这和标准库的容器是一样的. 需要强保证的调用者可以自己先拷贝再 swap.
+     * 
+     * 原来的版本按值传参，拷贝赋值和移动赋值共用一个函数. 但这样它就不能是 noexcept 的，
+     * 所以这里把两者分开.
      */
-    List &operator=(List copy)
+    List &operator=(const List &rhs)
     {
-    //    std::swap( *this, copy );
-    /// 这里直接 swap 两个对象是错误的，因为 List 并未定义 swap 操作.
-    /// 当发生右值引用时, 会导致一个对象被析构，而另一个对象被赋值.
-        std::swap( theSize, copy.theSize );
-        std::swap( head, copy.head );
-        std::swap( tail, copy.tail );
+        if (this == &rhs)
+            return *this;
+        NodeBase *p = head.next;
+        NodeBase *q = rhs.head.next;
+        /// 位置不变，索引也不用动.
+        for (; p != &tail && q != &rhs.tail; p = p->next, q = q->next)
+            dataOf( p ) = dataOf( q );
+        if (p != &tail)
+            erase( iterator{ p }, end( ) );
+        else if (q != &rhs.tail)
+        {
+            int n = rhs.theSize - theSize;
+            pool.reserve( n );
+            NodeBase *last = tail.prev;
+            appendCopies( const_iterator{ q }, n );
+            /// 新节点都在尾部，逐个加入索引.
+            if constexpr (Index<NodeBase>::enabled)
+                for (NodeBase *x = last->next; x != &tail; x = x->next)
+                    index.inserted( x );
+        }
         return *this;
     }
 
     /**
      * @brief 移动构造函数. 用于将一个右值引用的 List 的数据移动到另一个 List 中.
+     * rhs 之后是一张合法的空表，可以继续使用.
+     * 
+     * 只要不抛出异常，std::vector<List> 扩容时就会移动而不是拷贝每一张表.
+     * 只有内联节点需要搬动元素，所以只有那时才取决于元素的移动构造是否会抛出异常.
      * 
      * @param rhs 必须是一个右值引用. 因此不存在右操作数不存在的情况，不需要考虑缺省.
      */
-    List(List &&rhs) : theSize{ rhs.theSize }, head{ rhs.head }, tail{ rhs.tail }
+    List(List &&rhs) noexcept(nothrowMove) : pool{ std::move( rhs.pool ) }, index{ std::move( rhs.index ) }
     {
         /// 因为 rhs 是一个右值引用，所以我们最好直接将其数据置空. 
         /// 从而实现移动. 不然如果 rhs.head 还管理原来的数据，那么当它被析构时，
         /// 就可能释放掉已经移交给新对象的数据.
-        rhs.theSize = 0;
-        rhs.head = nullptr;
-        rhs.tail = nullptr;
+        /// 哨兵是各自的成员，所以接管数据节点后还要让首尾节点指向自己的哨兵.
+        init( );
+        swapLinks( rhs );
+        /// 放在 rhs 对象内部的节点没有随内存池过来，要搬到自己的内联缓冲区里.
+        relocateInline( rhs );
+    }
+
+    /**
+     * @brief 移动赋值运算符. 先释放自己原来的数据，再像移动构造那样接管 rhs 的数据.
+     * rhs 之后是一张合法的空表.
+     * 
+     * @param rhs 被移动的表.
+     * @return List& 当前表.
+     */
+    List &operator=(List &&rhs) noexcept(nothrowMove)
+    {
+        if (this != &rhs)
+        {
+            clear( );
+            moveFrom( rhs );
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 交换两张表的全部数据. 不拷贝元素，也不分配内存.
+     * 
+     * @param rhs 另一张表.
+     */
+    void swap(List &rhs) noexcept(nothrowMove)
+    {
+        if (this == &rhs)
+            return;
+        if constexpr (Allocator<Node>::inline_storage)
+        {
+            /// 内联节点不能随内存池交换，借助一个临时对象分三次移动.
+            List tmp( std::move( rhs ) );
+            rhs.moveFrom( *this );
+            moveFrom( tmp );
+        }
+        else
+        {
+            /// 哨兵在对象内部，不能直接交换指针，要把两串数据节点换个位置重新挂上.
+            swapLinks( rhs );
+            std::swap( pool, rhs.pool );   // 节点属于哪个内存池，内存池就要跟着节点走.
+            std::swap( index, rhs.index );
+        }
+    }
+
+    /**
+     * @brief 非成员的 swap, 使 std::swap(a, b) 之外的 using std::swap; swap(a, b);
+     * 这种写法通过实参依赖查找 (ADL) 找到上面的成员 swap.
+     * 
+     * @param a 一张表.
+     * @param b 另一张表.
+     */
+    friend void swap(List &a, List &b) noexcept(noexcept(a.swap(b)))
+    {
+        a.swap( b );
     }
-    
-    // // 这个功能已经被上面的实现所覆盖. 所以不再需要.
-    // List &operator=(List &&rhs)
-    // {
-    //     std::swap( theSize, rhs.theSize );
-    //     std::swap( head, rhs.head );
-    //     std::swap( tail, rhs.tail );
-    //     return *this;
-    // }
 
     /**
      * @brief 返回一个迭代器，指向 List 的第一个元素.
@@ -391,8 +513,8 @@ public:
      */
     iterator begin()
     {
-        /// head 指向的是一个哨兵节点，它的 next 指向的是第一个数据节点.
-        return { head->next };
+        /// head 是一个哨兵节点，它的 next 指向的是第一个数据节点.
+        return { head.next };
     }
 
     /**
@@ -402,7 +524,7 @@ public:
      */
     const_iterator begin() const
     {
-        return { head->next };
+        return { head.next };
     }
 
     /**
@@ -412,7 +534,7 @@ public:
      */
     iterator end()
     {
-        return { tail };
+        return { &tail };
     }
 
     /**
@@ -422,7 +544,71 @@ public:
      */
     const_iterator end() const
     {
-        return { tail };
+        return { const_cast<NodeBase *>( &tail ) };
+    }
+
+    /**
+     * @brief 无论 List 本身是否为 const，都返回只读的迭代器.
+     * 
+     * @return const_iterator 
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @brief 无论 List 本身是否为 const，都返回只读的尾后迭代器.
+     * 
+     * @return const_iterator 
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// 反向迭代器直接用标准库的适配器，它的 ++ 就是底层迭代器的 --.
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /**
+     * @brief 返回一个反向迭代器，指向 List 的最后一个元素.
+     * 
+     * @return reverse_iterator 
+     */
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator{ end() };
+    }
+
+    /**
+     * @brief 返回一个只读的反向迭代器，指向 List 的最后一个元素.
+     * 
+     * @return const_reverse_iterator 
+     */
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator{ end() };
+    }
+
+    /**
+     * @brief 返回一个反向迭代器，指向 List 的第一个元素之前.
+     * 
+     * @return reverse_iterator 
+     */
+    reverse_iterator rend()
+    {
+        return reverse_iterator{ begin() };
+    }
+
+    /**
+     * @brief 返回一个只读的反向迭代器，指向 List 的第一个元素之前.
+     * 
+     * @return const_reverse_iterator 
+     */
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator{ begin() };
     }
 
     /// 这里调用静态还是动态，实际上取决于调用的环境. 如果调用的是 const 对象，那么就会调用 const 的版本. 
@@ -449,14 +635,16 @@ public:
     }
 
     /**
-     * @brief 清空 List 中的数据.
+     * @brief 清空 List 中的数据. 元素可平凡析构并且内存池支持整体释放时,
+     * 不需要遍历任何节点.
      * 
      */
     void clear()
     {
-        /// 这里其实用计数器来判断 List 是否为空.
-        while (!empty())
-            pop_front();
+        destroyAll( );
+        /// 内存池可以整体释放时，把所有节点的内存一次还掉. 哨兵不受影响.
+        if (Allocator<Node>::bulk_release)
+            pool.release( );
     }
 
     /**
@@ -507,6 +695,68 @@ public:
         return *--end();
     }
 
+    /**
+     * @brief 返回第 k 个元素 (从 0 开始). 有索引时 O(log n)，否则要从头走 k 步.
+     * 
+     * @param k 位置.
+     * @return Object& 第 k 个元素.
+     */
+    Object &at(int k)
+    {
+        if (k < 0 || k >= theSize)
+            throw std::out_of_range("List index out of range");
+        return dataOf( index.select( &head, k + 1 ) );
+    }
+
+    /**
+     * @brief 返回第 k 个元素 (从 0 开始).
+     * 
+     * @param k 位置.
+     * @return const Object& 只读.
+     */
+    const Object &at(int k) const
+    {
+        if (k < 0 || k >= theSize)
+            throw std::out_of_range("List index out of range");
+        return dataOf( index.select( const_cast<NodeBase *>( &head ), k + 1 ) );
+    }
+
+    /**
+     * @brief 返回迭代器指向的元素是第几个 (从 0 开始)，end() 返回 size().
+     * 有索引时 O(log n)，否则要一直走回表头.
+     * 
+     * @param itr 本表的迭代器.
+     * @return int 位置.
+     */
+    int index_of(const_iterator itr) const
+    {
+        return index.rank( itr.current ) - 1;
+    }
+
+    /**
+     * @brief 返回 itr 向后移动 k 个位置 (k 为负时向前) 之后的迭代器. 有索引时先求出 itr 的位置，
+     * 再按位置查找，O(log n)，越界时抛出异常; 否则就是 std::advance，与它一样不检查越界.
+     * 
+     * @param itr 本表的迭代器.
+     * @param k 移动的距离.
+     * @return iterator 移动之后的迭代器，可以是 end().
+     */
+    iterator advance(iterator itr, int k)
+    {
+        if constexpr (Index<NodeBase>::enabled)
+        {
+            int r = index.rank( itr.current ) + k;
+            if (r < 1 || r > theSize + 1)
+                throw std::out_of_range("List iterator advanced out of range");
+            return { index.select( &head, r ) };
+        }
+        else
+        {
+            std::advance(itr, k);
+            return itr;
+        }
+    }
+
     /**
      * @brief 将一个左值数据节点插入到 List 的头部.
      * 
@@ -547,6 +797,30 @@ public:
         insert(end(), std::move(x));
     }
 
+    /**
+     * @brief 用 args 在 List 的头部直接构造一个元素.
+     * 
+     * @param args 传给 Object 构造函数的参数.
+     * @return Object& 新构造的元素.
+     */
+    template <typename... Args>
+    Object &emplace_front(Args &&...args)
+    {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 用 args 在 List 的尾部直接构造一个元素.
+     * 
+     * @param args 传给 Object 构造函数的参数.
+     * @return Object& 新构造的元素.
+     */
+    template <typename... Args>
+    Object &emplace_back(Args &&...args)
+    {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
     /**
      * @brief 删除 List 的第一个数据节点.
      * 
@@ -574,10 +848,7 @@ public:
      */
     iterator insert(iterator itr, const Object &x)
     {
-        Node *p = itr.current;
-        theSize++;
-        /// 仔细想一下这个过程.
-        return { p->prev = p->prev->next = new Node{ x, p->prev, p } };
+        return emplace(itr, x);
     }
 
     /**
@@ -589,9 +860,26 @@ public:
      */
     iterator insert(iterator itr, Object &&x)
     {
-        Node *p = itr.current;
+        return emplace(itr, std::move(x));
+    }
+
+    /**
+     * @brief 在指定位置之前直接构造一个元素. args 一路转发到 Node 的构造函数，
+     * 元素在节点的内存上就地构造，不产生临时对象，也不需要拷贝或移动.
+     * 
+     * @param itr 插入位置的迭代器.
+     * @param args 传给 Object 构造函数的参数.
+     * @return iterator 返回插入位置的迭代器.
+     */
+    template <typename... Args>
+    iterator emplace(iterator itr, Args &&...args)
+    {
+        NodeBase *p = itr.current;
+        /// 仔细想一下这个过程.
+        p->prev = p->prev->next = createNode( p->prev, p, std::forward<Args>( args )... );
         theSize++;
-        return { p->prev = p->prev->next = new Node{ std::move( x ), p->prev, p } };
+        index.inserted( p->prev );
+        return { p->prev };
     }
 
     /**
@@ -602,16 +890,17 @@ public:
      */
     iterator erase(iterator itr)
     {
-        if(itr != tail && itr != head)     // 输入的迭代器不能是 head 和 tail
+        if(itr.current != &tail && itr.current != &head)     // 输入的迭代器不能是 head 和 tail
         {
-            Node *p = itr.current;
+            NodeBase *p = itr.current;
             iterator retVal{ p->next };
+            index.erasing( p );
             p->prev->next = p->next;
             p->next->prev = p->prev;
-            delete p;
+            destroyNode(static_cast<Node *>(p));
             theSize--;
             return retVal;
-        } else if (itr == head)
+        } else if (itr.current == &head)
             return ++itr;
         else
             return itr;
@@ -635,27 +924,281 @@ public:
         if (from == to)
             return from; // 如果from和to相同，不进行任何操作
 
-        // 连接from的前一个节点和to的后一个节点
-        if (from.current->prev) {
-            from.current->prev->next = to.current;
-        } else {
-            // 如果from是第一个节点，更新头指针
-            head = to.current;
+        /// 删除整张表就是 clear, 内存可以整体释放.
+        if (from == begin() && to == end())
+        {
+            clear( );
+            return end( );
         }
-        to.current->prev = from.current->prev;
 
-        // 删除from至to的所有节点
-        iterator itr = from;
-        while (itr != to) {
-            iterator tmp = itr; // 保存当前迭代器的位置
-            delete tmp.current; // 删除当前节点
-            --theSize;          // 更新容器大小
-            ++itr;              // 更新迭代器
+        // 先把 [first, last] 整段摘下来，只需要改两个指针
+        NodeBase *first = from.current;
+        NodeBase *last = to.current->prev;
+        /// 有索引时逐个移出索引，每个 O(log n). 要从后往前删，这样前面的节点在索引中的位置不受影响.
+        if constexpr (Index<NodeBase>::enabled)
+            for (NodeBase *p = last; p != first->prev; p = p->prev)
+                index.erasing( p );
+        unlink(first, last);
+
+        if constexpr (trivialNodes)
+        {
+            /// 元素不需要析构，数出个数之后整段交还给内存池.
+            theSize -= count(first, last);
+            pool.deallocate( static_cast<Node *>(first), static_cast<Node *>(last) );
+        }
+        else
+        {
+            // 逐个析构from至to的所有节点
+            for (;;)
+            {
+                NodeBase *next = first->next;   // 节点归还给内存池之后就不能再读了
+                destroyNode(static_cast<Node *>(first));
+                --theSize;
+                if (first == last)
+                    break;
+                first = next;
+            }
         }
 
         return to;
     }
 
+    /**
+     * @brief 把 other 中的全部元素移到 pos 之前. 只改指针，不分配也不拷贝元素.
+     * 对于 NodePool 这类节点不能换主人的分配器，会整体接管 other 的内存池.
+     * 
+     * @param pos 插入位置.
+     * @param other 另一张表，结束后为空.
+     */
+    void splice(iterator pos, List &other)
+    {
+        if (this == &other || other.empty())
+            return;
+        std::pair<NodeBase *, NodeBase *> range = takeAll(other);
+        linkBefore(pos.current, range.first, range.second);
+        index.rebuild( &head, &tail );
+    }
+
+    /**
+     * @brief 把 other 中 itr 指向的一个元素移到 pos 之前. other 可以就是当前表.
+     * 
+     * @param pos 插入位置.
+     * @param other itr 所在的表.
+     * @param itr 被移动的元素.
+     */
+    void splice(iterator pos, List &other, iterator itr)
+    {
+        iterator next = itr;
+        splice(pos, other, itr, ++next);
+    }
+
+    /**
+     * @brief 把 other 中 [from, to) 的元素移到 pos 之前. 同一张表内或者节点可以换主人时，
+     * 只需要改常数个指针 (跨表时还要数一下个数来维护 size). 否则节点属于 other 的内存池，
+     * 只能在当前表的内存池中新建节点，把元素一个个移动过来，再把旧节点还给 other 的内存池，
+     * 代价与这一段的长度成正比，两个内存池仍然互不相干. 这时指向被移动元素的迭代器失效.
+     * 移动元素时抛出异常，已经移过来的元素留在当前表，其余的仍在 other 中.
+     * 
+     * @param pos 插入位置，不能落在 [from, to) 之内.
+     * @param other from 和 to 所在的表.
+     * @param from 起始位置.
+     * @param to 结束位置.
+     */
+    void splice(iterator pos, List &other, iterator from, iterator to)
+    {
+        if (from == to || pos == from)
+            return;
+        NodeBase *first = from.current;
+        NodeBase *last = to.current->prev;
+        if (this == &other)
+        {
+            if (first == last)
+            {
+                /// 只移动一个节点时，在索引中先删后插，O(log n).
+                index.erasing( first );
+                unlink(first, last);
+                linkBefore(pos.current, first, last);
+                index.inserted( first );
+                return;
+            }
+            unlink(first, last);
+            linkBefore(pos.current, first, last);
+            index.rebuild( &head, &tail );
+            return;
+        }
+        if constexpr (!Allocator<Node>::transferable)
+        {
+            if (from == other.begin() && to == other.end())
+            {
+                splice(pos, other);
+                return;
+            }
+            while (from != to)
+            {
+                insert(pos, std::move(*from));
+                from = other.erase(from);
+            }
+        }
+        else
+        {
+            int n = count(first, last);
+            other.unlink(first, last);
+            other.theSize -= n;
+            linkBefore(pos.current, first, last);
+            theSize += n;
+            other.index.rebuild( &other.head, &other.tail );
+            index.rebuild( &head, &tail );
+        }
+    }
+
+    /**
+     * @brief 把有序表 other 归并到当前有序表中，O(n + m)，不分配节点. 相等的元素中，
+     * 当前表的排在前面. 结束后 other 为空. comp 抛出异常时，other 中还没有归并的元素
+     * 接到当前表的末尾，两张表仍然完好，只是当前表不再有序.
+     * 
+     * @param other 另一张有序表.
+     * @param comp 比较函数，comp(a, b) 为 true 表示 a 应排在 b 之前.
+     */
+    template <typename Compare>
+    void merge(List &other, Compare comp)
+    {
+        if (this == &other || other.empty())
+            return;
+        std::pair<NodeBase *, NodeBase *> range = takeAll(other);
+        range.second->next = nullptr;
+        NodeBase *p = head.next;
+        NodeBase *q = range.first;
+        /// 依次为 other 的每个节点找到插入位置. p 只会向后走，所以总共是线性的.
+        while (q != nullptr)
+        {
+            bool before;
+            try
+            {
+                before = p == &tail || comp(dataOf(q), dataOf(p));
+            }
+            catch (...)
+            {
+                linkBefore(&tail, q, range.second);
+                index.rebuild( &head, &tail );
+                throw;
+            }
+            if (before)
+            {
+                NodeBase *next = q->next;
+                linkBefore(p, q, q);
+                q = next;
+            }
+            else
+                p = p->next;
+        }
+        index.rebuild( &head, &tail );
+    }
+
+    /**
+     * @brief 用 < 比较的归并.
+     * 
+     * @param other 另一张有序表.
+     */
+    void merge(List &other)
+    {
+        merge(other, std::less<Object>{});
+    }
+
+    /**
+     * @brief 自底向上的归并排序. 每一轮把长度为 width 的相邻两段归并，width 每轮加倍，
+     * 共 O(log n) 轮，每轮 O(n). 不用递归也不用辅助数组，只改节点的指针，所以排序前的
+     * 迭代器仍然指向原来的元素. 排序是稳定的. comp 抛出异常时，所有元素仍在表中，
+     * 只是顺序不定.
+     * 
+     * @param comp 比较函数，comp(a, b) 为 true 表示 a 应排在 b 之前.
+     */
+    template <typename Compare>
+    void sort(Compare comp)
+    {
+        if (theSize < 2)
+            return;
+        /// 排序时先当作以 nullptr 结尾的单链表处理，最后再补上 prev 指针.
+        NodeBase *list = head.next;
+        tail.prev->next = nullptr;
+        for (int width = 1; ; width *= 2)
+        {
+            NodeBase *p = list;
+            NodeBase *last = nullptr;
+            int merges = 0;
+            list = nullptr;
+            while (p != nullptr)
+            {
+                ++merges;
+                /// q 从 p 向后走 width 步，[p, q) 和 [q, q + width) 是要归并的两段.
+                NodeBase *q = p;
+                int psize = 0;
+                for (; psize < width && q != nullptr; ++psize)
+                    q = q->next;
+                int qsize = width;
+                while (psize > 0 || (qsize > 0 && q != nullptr))
+                {
+                    NodeBase *e;
+                    bool takeP;
+                    try
+                    {
+                        /// 只有 q 严格小于 p 时才取 q，这保证了稳定性.
+                        takeP = psize > 0 && (qsize == 0 || q == nullptr || !comp(dataOf(q), dataOf(p)));
+                    }
+                    catch (...)
+                    {
+                        /// 已经归并的部分、p 段剩下的 psize 个节点、q 及其后的节点重新接成一条链.
+                        NodeBase *rest = q;
+                        if (psize > 0)
+                        {
+                            NodeBase *r = p;
+                            for (int i = 1; i < psize; ++i)
+                                r = r->next;
+                            r->next = q;
+                            rest = p;
+                        }
+                        if (last != nullptr)
+                            last->next = rest;
+                        else
+                            list = rest;
+                        relinkChain(list);
+                        throw;
+                    }
+                    if (takeP)
+                    {
+                        e = p;
+                        p = p->next;
+                        --psize;
+                    }
+                    else
+                    {
+                        e = q;
+                        q = q->next;
+                        --qsize;
+                    }
+                    if (last != nullptr)
+                        last->next = e;
+                    else
+                        list = e;
+                    last = e;
+                }
+                p = q;
+            }
+            last->next = nullptr;
+            if (merges <= 1)
+                break;
+        }
+        relinkChain(list);
+    }
+
+    /**
+     * @brief 用 < 比较的排序.
+     * 
+     */
+    void sort()
+    {
+        sort(std::less<Object>{});
+    }
+
     /**
      * @brief 打印整个list
      * 
@@ -668,25 +1211,428 @@ public:
         std::cout << std::endl;
     }
 
+    /**
+     * @brief 按照 fmt 把所有元素写到 out 中. 元素先格式化到 out 的缓冲区里，攒满了才真正输出，
+     * 算术类型不经过 operator<<. 可以连续写好几张表，最后一起 flush.
+     * 
+     * @param out 输出缓冲区.
+     * @param fmt 分隔符、结尾，以及是否输出原始字节.
+     */
+    void write_to(OutputBuffer &out, const WriteFormat &fmt = {}) const
+    {
+        out.range(begin(), end(), fmt);
+    }
+
+    /**
+     * @brief 按照 fmt 把所有元素写到流 os 中. 只是临时建一个 OutputBuffer.
+     * 例如 list.write_to(std::cout) 和 printList 的输出基本相同，但快得多.
+     * 
+     * @param os 输出流.
+     * @param fmt 分隔符、结尾，以及是否输出原始字节.
+     */
+    void write_to(std::ostream &os, const WriteFormat &fmt = {}) const
+    {
+        OutputBuffer out(os);
+        write_to(out, fmt);
+    }
+
+    /**
+     * @brief 把整张表保存为一个二进制快照: 一个固定的文件头，然后是按表中顺序紧密排列的元素.
+     * 只用于可平凡拷贝的元素，这样元素的字节就是它的全部内容. 快照与机器的字节序和类型布局有关，
+     * 只应在同一个程序中读回.
+     * 
+     * @param path 文件路径. 写入失败时抛出 std::runtime_error.
+     */
+    void save(const std::string &path) const
+    {
+        static_assert(std::is_trivially_copyable<Object>::value,
+                      "List::save needs a trivially copyable element type");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("cannot open " + path);
+        SnapshotHeader header = snapshotHeader( theSize );
+        {
+            OutputBuffer out(file);
+            out.binary(header);
+            /// 补齐到元素的对齐要求，映射之后可以直接按 Object 读取.
+            for (std::size_t i = sizeof(header); i < header.offset; ++i)
+                out.binary('\0');
+            for (const Object &x : *this)
+                out.binary(x);
+        }
+        if (!file.flush())
+            throw std::runtime_error("failed to write " + path);
+    }
+
+    /**
+     * @brief 用 save 保存的快照替换当前表的内容. 文件被映射到内存，按顺序读一遍即可，
+     * 不需要逐个解析，也不经过 push_back. 节点事先在内存池中连续预留，所以按文件顺序排列
+     * 在同一块内存里，之后的遍历也是顺序访存.
+     * 
+     * @param path 文件路径. 打不开或者不是同类型的快照时抛出 std::runtime_error，当前表不变.
+     */
+    void load_mapped(const std::string &path)
+    {
+        static_assert(std::is_trivially_copyable<Object>::value,
+                      "List::load_mapped needs a trivially copyable element type");
+        MappedFile file(path);
+        SnapshotHeader header;
+        if (file.size() < sizeof(header))
+            throw std::runtime_error(path + " is not a List snapshot");
+        std::memcpy(&header, file.data(), sizeof(header));
+        SnapshotHeader expected = snapshotHeader( 0 );
+        if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+            header.version != expected.version || header.elementSize != expected.elementSize ||
+            header.offset != expected.offset)
+            throw std::runtime_error(path + " is not a snapshot of this List type");
+        if (header.count > INT_MAX || header.count > (file.size() - header.offset) / sizeof(Object))
+            throw std::runtime_error(path + " is truncated");
+
+        clear( );
+        pool.reserve( header.count );
+        appendCopies( reinterpret_cast<const Object *>( file.data() + header.offset ),
+                      static_cast<int>( header.count ) );
+        index.rebuild( &head, &tail );
+    }
+
 private:
+    /**
+     * @brief 快照的文件头. 记录元素的大小和个数，以及元素从文件的第几个字节开始.
+     */
+    struct SnapshotHeader
+    {
+        char magic[8];              /**<! 固定为 "DSLIST". */
+        std::uint32_t version;      /**<! 格式的版本. */
+        std::uint32_t elementSize;  /**<! sizeof(Object). */
+        std::uint64_t count;        /**<! 元素个数. */
+        std::uint64_t offset;       /**<! 第一个元素的位置，按 alignof(Object) 对齐. */
+    };
+
+    /**
+     * @brief 生成当前类型的快照文件头.
+     * 
+     * @param count 元素个数.
+     * @return SnapshotHeader 文件头.
+     */
+    static SnapshotHeader snapshotHeader(std::uint64_t count)
+    {
+        constexpr std::uint64_t align = alignof(Object);
+        SnapshotHeader h = { { 'D', 'S', 'L', 'I', 'S', 'T', 0, 0 }, 1, sizeof(Object), count,
+                             (sizeof(SnapshotHeader) + align - 1) / align * align };
+        return h;
+    }
+
     int theSize;    /**<! 数据节点总数. */
-    Node *head;     /**<! 头指针. */
-    Node *tail;     /**<! 尾指针. */
+    NodeBase head;  /**<! 头哨兵. */
+    NodeBase tail;  /**<! 尾哨兵. */
+    Allocator<Node> pool;   /**<! 节点的内存池. */
+    [[no_unique_address]] Index<NodeBase> index;  /**<! 按位置访问的索引. */
+
+    /// 移动一张表是否不会抛出异常. 只有搬动内联节点时才会调用元素的移动构造函数.
+    static constexpr bool nothrowMove = !Allocator<Node>::inline_storage ||
+                                        std::is_nothrow_move_constructible<Object>::value;
+
+    /// 元素可平凡析构时，节点也可平凡析构，很多遍历可以在编译期直接去掉.
+    static constexpr bool trivialNodes = std::is_trivially_destructible<Object>::value;
     
     /**
      * @brief 初始化 List. 用于构造函数中初始化 List. 构建一张空表.
+     * 哨兵是 List 的成员，只需要把它们连起来，不需要分配内存.
      * 
      */
     void init()
     {
         theSize = 0;
-        head = new Node;
-        tail = new Node;
-        head->next = tail;
-        tail->prev = head;
+        head.prev = nullptr;
+        head.next = &tail;
+        tail.prev = &head;
+        tail.next = nullptr;
+    }
+
+    /**
+     * @brief 取出数据节点中的数据.
+     * 
+     * @param p 数据节点，不能是哨兵.
+     * @return Object& 节点中的数据.
+     */
+    static Object &dataOf(NodeBase *p)
+    {
+        return static_cast<Node *>(p)->data;
+    }
+
+    /**
+     * @brief 从内存池中申请一个节点，并在上面构造. 构造抛出异常时要把空间还回去.
+     * 
+     * @param p 前一个节点的指针.
+     * @param n 后一个节点的指针.
+     * @param args 构造数据所用的参数.
+     * @return Node* 新节点.
+     */
+    template <typename... Args>
+    Node *createNode(NodeBase *p, NodeBase *n, Args &&...args)
+    {
+        Node *node = pool.allocate( );
+        try
+        {
+            return new (node) Node( p, n, std::forward<Args>( args )... );
+        }
+        catch (...)
+        {
+            pool.deallocate( node );
+            throw;
+        }
+    }
+
+    /**
+     * @brief 从 src 开始依次拷贝 n 个元素，接到表的尾部. 节点只在构造好之后才接到前一个节点上，
+     * 尾哨兵最后才修改，所以整个过程只有一趟. 不修改索引.
+     * 
+     * 元素可平凡拷贝时，构造就是一次 memcpy，也不可能抛出异常，回滚的代码在编译期就去掉了.
+     * 否则某个元素的拷贝抛出异常时，已经拷好的元素留在表里，表仍然是合法的.
+     * 
+     * @param src 指向第一个元素的迭代器或指针.
+     * @param n 元素个数.
+     */
+    template <typename Source>
+    void appendCopies(Source src, int n)
+    {
+        NodeBase *last = tail.prev;
+        for (int i = 0; i < n; ++i, ++src)
+        {
+            Node *node = pool.allocate( );
+            if constexpr (std::is_nothrow_copy_constructible<Object>::value)
+                new (node) Node( last, &tail, *src );
+            else
+            {
+                try
+                {
+                    new (node) Node( last, &tail, *src );
+                }
+                catch (...)
+                {
+                    pool.deallocate( node );
+                    last->next = &tail;
+                    tail.prev = last;
+                    throw;
+                }
+            }
+            last->next = node;
+            last = node;
+            ++theSize;
+        }
+        last->next = &tail;
+        tail.prev = last;
+    }
+
+    /**
+     * @brief 析构一个节点，并把空间还给内存池.
+     * 
+     * @param p 要销毁的节点.
+     */
+    void destroyNode(Node *p)
+    {
+        p->~Node( );
+        pool.deallocate( p );
+    }
+
+    /**
+     * @brief 把 [first, last] 一段节点从所在的表中摘下来. 不修改 size.
+     * 
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     */
+    static void unlink(NodeBase *first, NodeBase *last)
+    {
+        first->prev->next = last->next;
+        last->next->prev = first->prev;
+    }
+
+    /**
+     * @brief 把串好的 [first, last] 一段节点接到 pos 之前. 不修改 size.
+     * 
+     * @param pos 插入位置.
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     */
+    static void linkBefore(NodeBase *pos, NodeBase *first, NodeBase *last)
+    {
+        first->prev = pos->prev;
+        last->next = pos;
+        pos->prev->next = first;
+        pos->prev = last;
+    }
+
+    /**
+     * @brief 把以 nullptr 结尾、只有 next 指针可用的一条链挂回两个哨兵之间，补上 prev 指针
+     * 并重建索引. 链中必须恰好是表中的全部数据节点.
+     * 
+     * @param list 链的第一个节点.
+     */
+    void relinkChain(NodeBase *list)
+    {
+        NodeBase *prev = &head;
+        for (NodeBase *p = list; p != nullptr; p = p->next)
+        {
+            p->prev = prev;
+            prev = p;
+        }
+        head.next = list;
+        prev->next = &tail;
+        tail.prev = prev;
+        index.rebuild( &head, &tail );
+    }
+
+    /**
+     * @brief 数一下 [first, last] 中的节点个数.
+     * 
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     * @return int 节点个数.
+     */
+    static int count(NodeBase *first, NodeBase *last)
+    {
+        int n = 1;
+        for (; first != last; first = first->next)
+            ++n;
+        return n;
+    }
+
+    /**
+     * @brief 当前表为空时，把 [first, last] 共 n 个节点挂到两个哨兵之间.
+     * 
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     * @param n 节点个数.
+     */
+    void attach(NodeBase *first, NodeBase *last, int n)
+    {
+        head.next = first;
+        first->prev = &head;
+        tail.prev = last;
+        last->next = &tail;
+        theSize = n;
+    }
+
+    /**
+     * @brief 交换两张表的数据节点 (不含内存池). 哨兵各自留在原来的对象里.
+     * 
+     * @param rhs 另一张表.
+     */
+    void swapLinks(List &rhs)
+    {
+        NodeBase *first = head.next;
+        NodeBase *last = tail.prev;
+        int n = theSize;
+        init( );
+        if (!rhs.empty())
+            attach(rhs.head.next, rhs.tail.prev, rhs.theSize);
+        rhs.init( );
+        if (n > 0)
+            rhs.attach(first, last, n);
+    }
+
+    /**
+     * @brief 把 other 的全部数据节点摘下来交给当前表，other 变为空表.
+     * 节点不能换主人时，连同 other 的内存池一起接管. other 对象内部的内联节点接管不了，
+     * 只能把元素搬过来，指向它们的迭代器因此失效.
+     * 
+     * @param other 另一张非空的表.
+     * @return std::pair<NodeBase *, NodeBase *> 摘下来的第一个和最后一个节点，尚未接到当前表上.
+     */
+    std::pair<NodeBase *, NodeBase *> takeAll(List &other)
+    {
+        if constexpr (!Allocator<Node>::transferable)
+            pool.adopt( other.pool );
+        relocateInline( other );
+        /// 这些节点的索引随后由调用者重建.
+        other.index.clear( );
+        NodeBase *first = other.head.next;
+        NodeBase *last = other.tail.prev;
+        theSize += other.theSize;
+        other.init( );
+        return { first, last };
+    }
+
+    /**
+     * @brief 接管 from 的全部数据和内存池，from 变为空表. 调用前当前表必须是空的，
+     * 并且内存池中没有在用的节点.
+     * 
+     * @param from 另一张表.
+     */
+    void moveFrom(List &from) noexcept(nothrowMove)
+    {
+        pool = std::move( from.pool );
+        index = std::move( from.index );
+        swapLinks( from );
+        relocateInline( from );
+    }
+
+    /**
+     * @brief 把 from 的内存池里的内联节点逐个搬到当前表的内存池中. 节点仍然链在原来的位置上，
+     * 只是换成新节点，前后节点 (可能是哨兵) 的指针随之修改. 代价只与内联节点个数有关，与表长无关.
+     * 其它分配器的节点都不在对象内部，什么也不用做.
+     * 
+     * @param from 内联节点所在的表.
+     */
+    void relocateInline(List &from)
+    {
+        if constexpr (Allocator<Node>::inline_storage)
+            from.pool.for_each_inline([this, &from](Node *p) {
+                Node *q = createNode( p->prev, p->next, std::move( p->data ) );
+                Index<NodeBase>::relocated( p, q );
+                q->prev->next = q;
+                q->next->prev = q;
+                from.destroyNode( p );
+            });
+    }
+
+    /**
+     * @brief 析构所有数据节点中的元素. 内存是否归还由调用者决定:
+     * 支持整体释放的内存池随后一次 release 即可，否则这里逐个归还.
+     * 如果既不用析构也不用归还，就完全不需要遍历.
+     * 
+     */
+    void destroyAll()
+    {
+        if constexpr (!(trivialNodes && Allocator<Node>::bulk_release))
+        {
+            NodeBase *p = head.next;
+            while (p != &tail)
+            {
+                NodeBase *next = p->next;
+                if (Allocator<Node>::bulk_release)
+                    static_cast<Node *>(p)->~Node( );
+                else
+                    destroyNode(static_cast<Node *>(p));
+                p = next;
+            }
+        }
+        head.next = &tail;
+        tail.prev = &head;
+        theSize = 0;
+        index.clear( );
     }
 };
 
+/**
+ * @brief 短表优化的 List. 前 N 个节点放在 List 对象内部，超过 N 个才从堆上分配.
+ * 哨兵本来就是 List 的成员，所以元素不超过 N 个的 SmallList 完全不使用堆内存.
+ * 移动时只需要搬动至多 N 个内联节点，堆上的节点原样接管.
+ * 
+ * @tparam Object 元素类型.
+ * @tparam N 内联节点的个数，不超过 64.
+ */
+template <typename Object, std::size_t N = 8>
+using SmallList = List<Object, InlineNodes<N>::template Pool>;
+
+/**
+ * @brief 带跳表索引的 List. at, index_of 和 advance 都是 O(log n) 的.
+ * 
+ * @tparam Object 元素类型.
+ */
+template <typename Object>
+using IndexedList = List<Object, NodePool, SkipIndex>;
+
 #else
 // DO NOTHING.
 #endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef __MAPPED_FILE_MARK__
+#define __MAPPED_FILE_MARK__
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 只读地把整个文件映射到内存. 文件的内容不会被一次性读进来, 而是在访问到时由操作系统
+ * 按页调入, 对顺序读取还会预读. 析构时解除映射.
+ *
+ * 在没有 mmap 的 Windows 上退回到把整个文件读进一块内存.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief 打开并映射 path. 打不开或者映射失败时抛出 std::runtime_error.
+     *
+     * @param path 文件路径.
+     */
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("cannot open " + path);
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        base = buffer.data();
+        length = buffer.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        if (length > 0)
+        {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            /// Linux 上可以在映射时就把整个文件调入, 避免之后逐页触发缺页中断.
+            flags |= MAP_POPULATE;
+#endif
+            void *p = ::mmap(nullptr, length, PROT_READ, flags, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path);
+            }
+            /// 告诉内核我们会顺序读取, 让它加大预读.
+            ::madvise(p, length, MADV_SEQUENTIAL);
+            base = static_cast<const char *>(p);
+        }
+        /// 映射建立之后就不再需要文件描述符了.
+        ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (base != nullptr)
+            ::munmap(const_cast<char *>(base), length);
+#endif
+    }
+
+    /**
+     * @brief 文件内容的起始地址. 映射按页对齐.
+     *
+     * @return const char* 起始地址, 空文件为 nullptr.
+     */
+    const char *data() const
+    {
+        return base;
+    }
+
+    /**
+     * @brief 文件的字节数.
+     *
+     * @return std::size_t 字节数.
+     */
+    std::size_t size() const
+    {
+        return length;
+    }
+
+private:
+    const char *base = nullptr; /**<! 映射的起始地址. */
+    std::size_t length = 0;     /**<! 映射的长度. */
+#ifdef _WIN32
+    std::vector<char> buffer;   /**<! 读进来的文件内容. */
+#endif
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,514 @@
+#ifndef __NODE_POOL_MARK__
+#define __NODE_POOL_MARK__
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief 直接调用全局 operator new / operator delete 的节点分配策略.
+ * 每个节点单独申请、单独释放, 也就是 List 最初的做法. 保留它主要是为了对比性能.
+ *
+ * 一个分配策略需要提供:
+ *   - T *allocate()            申请一个 T 大小的未初始化空间;
+ *   - void deallocate(T *p)    归还一个空间, 调用前 p 上的对象必须已经析构;
+ *   - void deallocate(T *first, T *last)
+ *                              归还沿 next 指针串起来的 [first, last] 一段节点,
+ *                              只用于可平凡析构的 T, 节点不必 (也不会) 析构;
+ *   - void release()           一次性归还所有空间 (仅当 bulk_release 为 true 时有意义);
+ *   - void reserve(std::size_t n)
+ *                              提示接下来要连续分配 n 个节点, 分配器可以借此把它们放在一起;
+ *   - void adopt(Pool &other)  接管另一个同类分配器分配出的全部空间;
+ *   - static constexpr bool bulk_release  是否支持 release;
+ *   - static constexpr bool transferable  一个节点能否直接挂到另一个 List 上,
+ *                              即它的空间能否由另一个分配器归还.
+ *   - static constexpr bool inline_storage
+ *                              节点是否可能放在分配器对象自身里面. 这样的分配器被移动时,
+ *                              这些节点不会跟着走, 需要 List 把它们搬到新的分配器中
+ *                              (见 InlineNodes).
+ *
+ * @tparam T 要分配的对象类型, 对 List 来说就是 Node.
+ */
+template <typename T>
+class NewAllocator
+{
+public:
+    static constexpr bool bulk_release = false; /**<! 全局 new 无法整体释放. */
+    static constexpr bool transferable = true;  /**<! 谁来 delete 都一样. */
+    static constexpr bool inline_storage = false; /**<! 节点都在堆上. */
+
+    /**
+     * @brief 申请一个节点大小的空间.
+     *
+     * @return T* 未初始化的空间.
+     */
+    T *allocate()
+    {
+        return static_cast<T *>(::operator new(sizeof(T)));
+    }
+
+    /**
+     * @brief 归还一个节点的空间.
+     *
+     * @param p 已经析构过的节点.
+     */
+    void deallocate(T *p)
+    {
+        ::operator delete(p);
+    }
+
+    /**
+     * @brief 归还一段节点. 全局 new 只能一个一个地 delete.
+     *
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     */
+    void deallocate(T *first, T *last)
+    {
+        for (;;)
+        {
+            T *next = static_cast<T *>(first->next);
+            ::operator delete(first);
+            if (first == last)
+                break;
+            first = next;
+        }
+    }
+
+    /**
+     * @brief 全局 new 并不记录分配过的空间, 因此什么也不做.
+     *
+     */
+    void release()
+    {
+    }
+
+    /**
+     * @brief 每个节点单独申请, 无法预留.
+     *
+     */
+    void reserve(std::size_t)
+    {
+    }
+
+    /**
+     * @brief 所有空间本来就属于全局堆, 不需要接管.
+     *
+     */
+    void adopt(NewAllocator &)
+    {
+    }
+};
+
+/**
+ * @brief 每个 List 私有的 slab 内存池. 节点从连续的大块 (chunk) 中依次切出,
+ * 被删除的节点挂到一个侵入式的空闲链表上, 下次分配时优先复用. 所有 chunk
+ * 在 release() 或析构时一次性归还, 不必逐个 delete 节点.
+ *
+ * 对于可平凡析构的节点, 一整段已经用 next 串好的节点可以原样挂到回收链上,
+ * 这只需要改一个指针, 与这段的长度无关.
+ *
+ * chunk 的大小从 MIN_CHUNK 开始倍增, 直到 MAX_CHUNK 为止. 这样短表不会浪费
+ * 太多内存, 长表的 chunk 数量也是对数级的.
+ *
+ * 节点不能换主人: 跨表 splice 一段时, List 在自己的池中新建节点并把元素移过来.
+ * 如果让两个池共享 chunk, 移走一个节点就会把对方的整个池留住.
+ *
+ * @tparam T 要分配的对象类型.
+ */
+template <typename T>
+class NodePool
+{
+public:
+    static constexpr bool bulk_release = true; /**<! 可以整体释放. */
+    static constexpr bool transferable = false; /**<! 节点的空间属于某一个池. */
+    static constexpr bool inline_storage = false; /**<! chunk 都在堆上, 移动内存池时节点不用动. */
+
+    NodePool() = default;
+
+    /// 内存池只属于一个 List, 拷贝它没有意义.
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    /**
+     * @brief 移动构造函数. 直接接管对方的全部 chunk, 对方变成一个空池.
+     *
+     * @param rhs 被移动的内存池.
+     */
+    NodePool(NodePool &&rhs) noexcept
+        : chunks{rhs.chunks}, freeList{rhs.freeList}, recycled{rhs.recycled},
+          cursor{rhs.cursor}, limit{rhs.limit}, nextChunkSize{rhs.nextChunkSize}
+    {
+        rhs.chunks = nullptr;
+        rhs.freeList = nullptr;
+        rhs.recycled = nullptr;
+        rhs.cursor = rhs.limit = nullptr;
+        rhs.nextChunkSize = MIN_CHUNK;
+    }
+
+    /**
+     * @brief 移动赋值. 交换之后, 原来的 chunk 随 rhs 一起释放.
+     *
+     * @param rhs 被移动的内存池.
+     * @return NodePool& 当前内存池.
+     */
+    NodePool &operator=(NodePool &&rhs) noexcept
+    {
+        std::swap(chunks, rhs.chunks);
+        std::swap(freeList, rhs.freeList);
+        std::swap(recycled, rhs.recycled);
+        std::swap(cursor, rhs.cursor);
+        std::swap(limit, rhs.limit);
+        std::swap(nextChunkSize, rhs.nextChunkSize);
+        return *this;
+    }
+
+    ~NodePool()
+    {
+        release();
+    }
+
+    /**
+     * @brief 申请一个节点大小的空间. 优先从空闲链表和回收链中取, 否则从当前 chunk 中切一个,
+     * 当前 chunk 用完了才向系统申请新的 chunk.
+     *
+     * @return T* 未初始化的空间.
+     */
+    T *allocate()
+    {
+        if (recycled != nullptr)
+        {
+            T *p = recycled;
+            recycled = static_cast<T *>(p->next);
+            return p;
+        }
+        Slot *s;
+        if (freeList != nullptr)
+        {
+            s = freeList;
+            freeList = s->link;
+        }
+        else
+        {
+            if (cursor == limit)
+                grow();
+            s = cursor++;
+        }
+        return reinterpret_cast<T *>(s->storage);
+    }
+
+    /**
+     * @brief 把一个节点的空间挂回空闲链表. 这里只是改了一个指针, 是 O(1) 的.
+     *
+     * @param p 已经析构过的节点.
+     */
+    void deallocate(T *p)
+    {
+        Slot *s = reinterpret_cast<Slot *>(p);
+        s->link = freeList;
+        freeList = s;
+    }
+
+    /**
+     * @brief 把一段沿 next 串好的节点整体挂到回收链上. 节点本身没有析构,
+     * 它们的 next 指针仍然有效, 所以回收链可以直接借用, O(1).
+     *
+     * @param first 第一个节点.
+     * @param last 最后一个节点 (包含).
+     */
+    void deallocate(T *first, T *last)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "only trivially destructible nodes can be recycled as a chain");
+        last->next = recycled;
+        recycled = first;
+    }
+
+    /**
+     * @brief 一次性归还所有 chunk. 调用之后之前分配出的所有空间都失效.
+     *
+     */
+    void release()
+    {
+        while (chunks != nullptr)
+        {
+            Slot *next = chunks->link;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+        freeList = nullptr;
+        recycled = nullptr;
+        cursor = limit = nullptr;
+        nextChunkSize = MIN_CHUNK;
+    }
+
+    /**
+     * @brief 保证在空闲链表和回收链用完之后, 接下来的 n 次分配从同一个 chunk 中按地址顺序连续切出.
+     * 当前 chunk 剩下的格子不够时, 直接申请一个恰好 n 格的 chunk, 当前 chunk 剩下的格子就不再使用了,
+     * 等到 release 时一起释放.
+     *
+     * @param n 节点个数.
+     */
+    void reserve(std::size_t n)
+    {
+        if (static_cast<std::size_t>(limit - cursor) < n)
+            addChunk(n + 1);
+    }
+
+    /**
+     * @brief 接管另一个内存池的全部 chunk, 对方变成一个空池. 两张表整体合并时,
+     * 节点因此不必搬家. 只要当前池的空闲链表或当前 chunk 已经用完, 就顺便接着用
+     * 对方的; 否则对方剩下的空闲格就等到 release 时一起释放.
+     *
+     * @param other 被接管的内存池.
+     */
+    void adopt(NodePool &other)
+    {
+        if (this == &other || other.chunks == nullptr)
+            return;
+        Slot *last = other.chunks;
+        while (last->link != nullptr)
+            last = last->link;
+        last->link = chunks;
+        chunks = other.chunks;
+        if (freeList == nullptr)
+            freeList = other.freeList;
+        if (recycled == nullptr)
+            recycled = other.recycled;
+        if (cursor == limit)
+        {
+            cursor = other.cursor;
+            limit = other.limit;
+        }
+        other.chunks = nullptr;
+        other.freeList = nullptr;
+        other.recycled = nullptr;
+        other.cursor = other.limit = nullptr;
+        other.nextChunkSize = MIN_CHUNK;
+    }
+
+private:
+    /**
+     * @brief 内存池中的一格. 空闲时用来存放空闲链表的指针, 使用时存放一个 T.
+     * 用 union 使两者共享同一块内存, 所以空闲链表不需要额外的空间.
+     */
+    union Slot
+    {
+        Slot *link;                                    /**<! 空闲时指向下一个空闲格. */
+        alignas(T) unsigned char storage[sizeof(T)];   /**<! 使用时存放节点. */
+    };
+
+    static constexpr std::size_t MIN_CHUNK = 16;    /**<! 第一个 chunk 的格数. */
+    static constexpr std::size_t MAX_CHUNK = 4096;  /**<! chunk 的最大格数. */
+
+    Slot *chunks = nullptr;     /**<! 已申请的 chunk 链表, 每个 chunk 的第 0 格用来串起 chunk 本身. */
+    Slot *freeList = nullptr;   /**<! 空闲链表. */
+    T *recycled = nullptr;      /**<! 整段回收的节点, 沿节点自己的 next 串起来. */
+    Slot *cursor = nullptr;     /**<! 当前 chunk 中下一个未用过的格. */
+    Slot *limit = nullptr;      /**<! 当前 chunk 的末尾. */
+    std::size_t nextChunkSize = MIN_CHUNK; /**<! 下一个 chunk 的格数. */
+
+    /**
+     * @brief 按倍增的大小申请下一个 chunk.
+     *
+     */
+    void grow()
+    {
+        addChunk(nextChunkSize);
+        if (nextChunkSize < MAX_CHUNK)
+            nextChunkSize *= 2;
+    }
+
+    /**
+     * @brief 向系统申请一个 slots 格的 chunk. 第 0 格记录上一个 chunk, 其余的格供分配.
+     *
+     * @param slots chunk 的格数, 含第 0 格.
+     */
+    void addChunk(std::size_t slots)
+    {
+        Slot *chunk = static_cast<Slot *>(::operator new(slots * sizeof(Slot)));
+        chunk->link = chunks;
+        chunks = chunk;
+        cursor = chunk + 1;
+        limit = chunk + slots;
+    }
+};
+
+/**
+ * @brief 带内联缓冲区的分配策略. 前 N 个节点直接放在分配器对象里, 也就是放在 List 对象里,
+ * 超出的部分才交给一个 NodePool 从堆上分配. 大多数表都很短, 这样它们完全不需要堆内存.
+ *
+ * 因为 List 的模板参数只接受一个类型参数的分配器, 这里把 N 放在外层:
+ * List<Object, InlineNodes<8>::template Pool> 就是一个有 8 个内联节点的表 (见 SmallList).
+ *
+ * 内联缓冲区的占用情况用一个位图记录, 所以 N 不能超过 64.
+ *
+ * @tparam N 内联节点的个数.
+ */
+template <std::size_t N>
+struct InlineNodes
+{
+    static_assert(N > 0 && N <= 64, "InlineNodes supports 1 to 64 inline nodes");
+
+    template <typename T>
+    class Pool
+    {
+    public:
+        static constexpr bool bulk_release = true;   /**<! 清空位图并释放堆上的部分即可. */
+        static constexpr bool transferable = false;  /**<! 内联节点属于某一个 List 对象. */
+        static constexpr bool inline_storage = true; /**<! 移动时内联节点要由 List 搬家. */
+
+        Pool() = default;
+
+        Pool(const Pool &) = delete;
+        Pool &operator=(const Pool &) = delete;
+
+        /**
+         * @brief 移动构造函数. 只接管堆上的部分, O(1). 内联节点还留在 rhs 中,
+         * 由 List 通过 relocate 一个一个搬过来.
+         *
+         * @param rhs 被移动的分配器.
+         */
+        Pool(Pool &&rhs) noexcept : spill{std::move(rhs.spill)}
+        {
+        }
+
+        /**
+         * @brief 移动赋值. 与移动构造一样只交换堆上的部分, 调用前当前分配器不能有内联节点在用.
+         *
+         * @param rhs 被移动的分配器.
+         * @return Pool& 当前分配器.
+         */
+        Pool &operator=(Pool &&rhs) noexcept
+        {
+            spill = std::move(rhs.spill);
+            return *this;
+        }
+
+        /**
+         * @brief 申请一个节点. 内联缓冲区还有空位就用内联的, 否则从堆上分配.
+         *
+         * @return T* 未初始化的空间.
+         */
+        T *allocate()
+        {
+            if (used != FULL)
+            {
+                int i = std::countr_one(used);
+                used |= std::uint64_t{1} << i;
+                return reinterpret_cast<T *>(slots[i].storage);
+            }
+            return spill.allocate();
+        }
+
+        /**
+         * @brief 归还一个节点.
+         *
+         * @param p 已经析构过的节点.
+         */
+        void deallocate(T *p)
+        {
+            if (owns(p))
+                used &= ~(std::uint64_t{1} << index(p));
+            else
+                spill.deallocate(p);
+        }
+
+        /**
+         * @brief 归还一段沿 next 串好的节点. 其中可能混有内联节点, 只能逐个归还.
+         *
+         * @param first 第一个节点.
+         * @param last 最后一个节点 (包含).
+         */
+        void deallocate(T *first, T *last)
+        {
+            for (;;)
+            {
+                T *next = static_cast<T *>(first->next);
+                deallocate(first);
+                if (first == last)
+                    break;
+                first = next;
+            }
+        }
+
+        /**
+         * @brief 一次性归还所有空间.
+         *
+         */
+        void release()
+        {
+            used = 0;
+            spill.release();
+        }
+
+        /**
+         * @brief 预留 n 个节点. 内联缓冲区的空位先用, 剩下的在堆上连续预留.
+         *
+         * @param n 节点个数.
+         */
+        void reserve(std::size_t n)
+        {
+            std::size_t free = N - std::popcount(used);
+            if (n > free)
+                spill.reserve(n - free);
+        }
+
+        /**
+         * @brief 接管另一个分配器堆上的部分. 对方的内联节点必须事先由 List 搬走.
+         *
+         * @param other 被接管的分配器.
+         */
+        void adopt(Pool &other)
+        {
+            spill.adopt(other.spill);
+        }
+
+        /**
+         * @brief 对每个正在使用的内联节点调用一次 f. f 可以归还这个节点.
+         * List 用它把内联节点搬到另一个分配器, 代价只和 N 有关, 与表长无关.
+         *
+         * @param f 接受一个 T * 的函数.
+         */
+        template <typename F>
+        void for_each_inline(F f)
+        {
+            for (std::uint64_t rest = used; rest != 0; rest &= rest - 1)
+                f(reinterpret_cast<T *>(slots[std::countr_zero(rest)].storage));
+        }
+
+    private:
+        /**
+         * @brief 内联缓冲区中的一格.
+         */
+        struct Slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        static constexpr std::uint64_t FULL = N == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << N) - 1;
+
+        Slot slots[N];              /**<! 内联缓冲区. */
+        std::uint64_t used = 0;     /**<! 第 i 位为 1 表示第 i 格正在使用. */
+        NodePool<T> spill;          /**<! 超出 N 个之后的节点. */
+
+        bool owns(const T *p) const
+        {
+            auto x = reinterpret_cast<std::uintptr_t>(p);
+            auto begin = reinterpret_cast<std::uintptr_t>(slots);
+            return x >= begin && x < begin + sizeof(slots);
+        }
+
+        int index(const T *p) const
+        {
+            return (reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(slots)) / sizeof(Slot);
+        }
+    };
+};
+
+#else
+// DO NOTHING.
+#endif
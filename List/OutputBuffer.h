@@ -0,0 +1,215 @@
+#ifndef __OUTPUT_BUFFER_MARK__
+#define __OUTPUT_BUFFER_MARK__
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief write_to 的输出格式.
+ *
+ * 文本模式下, 元素之间写 separator, 最后写 terminator. 二进制模式下依次写出每个元素的原始字节,
+ * 不写分隔符也不写结尾, 只能用于可平凡拷贝的元素.
+ */
+struct WriteFormat
+{
+    std::string_view separator = " ";   /**<! 元素之间的分隔符. */
+    std::string_view terminator = "\n"; /**<! 最后一个元素之后的结尾. */
+    bool binary = false;                /**<! 是否输出原始字节. */
+};
+
+/**
+ * @brief 带缓冲区的输出. 数据先格式化到一块预先申请好的缓冲区里, 攒满了才一次写到底层的流,
+ * 所以输出一百万个元素只需要几十次真正的写操作. 算术类型用 std::to_chars 格式化,
+ * 不经过 locale, 也不申请内存. 其它类型退回到 operator<<.
+ *
+ * 析构时自动 flush.
+ */
+class OutputBuffer
+{
+public:
+    /**
+     * @brief 构造一个写到 os 的缓冲区.
+     *
+     * @param os 底层的输出流.
+     * @param capacity 缓冲区大小 (字节), 至少为 MIN_CAPACITY.
+     */
+    explicit OutputBuffer(std::ostream &os, std::size_t capacity = 64 * 1024)
+        : out{os}, size{capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity},
+          buffer{new char[size]}, used{0}
+    {
+    }
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    ~OutputBuffer()
+    {
+        flush();
+    }
+
+    /**
+     * @brief 把缓冲区中的数据写到底层的流.
+     *
+     */
+    void flush()
+    {
+        if (used > 0)
+        {
+            out.write(buffer.get(), used);
+            used = 0;
+        }
+    }
+
+    /**
+     * @brief 写出一段字节. 比剩余空间长时先 flush, 比整个缓冲区还长就直接写到底层的流.
+     *
+     * @param p 数据.
+     * @param n 字节数.
+     */
+    void write(const char *p, std::size_t n)
+    {
+        if (n > size - used)
+        {
+            flush();
+            if (n > size)
+            {
+                out.write(p, n);
+                return;
+            }
+        }
+        std::memcpy(buffer.get() + used, p, n);
+        used += n;
+    }
+
+    /**
+     * @brief 写出一个字符串.
+     *
+     * @param s 字符串.
+     */
+    void write(std::string_view s)
+    {
+        write(s.data(), s.size());
+    }
+
+    /**
+     * @brief 以文本形式写出一个值. 算术类型用 std::to_chars 直接格式化到缓冲区里,
+     * 字符 (包括 signed char 和 unsigned char) 和字符串原样写出, 其它类型用 operator<< 格式化.
+     *
+     * @param x 要写出的值.
+     */
+    template <typename T>
+    void text(const T &x)
+    {
+        if constexpr (std::is_same<T, char>::value)
+            write(&x, 1);
+        else if constexpr (std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value)
+        {
+            /// operator<< 把它们也当作字符.
+            char c = static_cast<char>(x);
+            write(&c, 1);
+        }
+        else if constexpr (std::is_same<T, bool>::value)
+            write(x ? "1" : "0", 1);
+        else if constexpr (std::is_arithmetic<T>::value)
+        {
+            /// 最长的 double 也不超过 MIN_CAPACITY 个字符.
+            if (size - used < MIN_CAPACITY)
+                flush();
+            std::to_chars_result r = std::to_chars(buffer.get() + used, buffer.get() + size, x);
+            used = r.ptr - buffer.get();
+        }
+        else if constexpr (std::is_convertible<const T &, std::string_view>::value)
+            write(std::string_view(x));
+        else
+        {
+            /// 退回到 operator<<. 格式化用的流是重复使用的, 只在第一次用到时构造.
+            if (!fallback)
+                fallback.reset(new std::ostringstream);
+            fallback->str(std::string());
+            *fallback << x;
+            write(fallback->str());
+        }
+    }
+
+    /**
+     * @brief 写出一个值的原始字节.
+     *
+     * @param x 要写出的值, 必须可平凡拷贝.
+     */
+    template <typename T>
+    void binary(const T &x)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "binary output needs a trivially copyable type");
+        write(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
+    /**
+     * @brief 按照 fmt 写出表中的一个元素. 文本模式下除了第一个元素, 每个元素之前先写分隔符.
+     *
+     * @param x 元素.
+     * @param fmt 输出格式.
+     * @param first 是否是第一个元素.
+     */
+    template <typename T>
+    void element(const T &x, const WriteFormat &fmt, bool first)
+    {
+        if (fmt.binary)
+        {
+            if constexpr (std::is_trivially_copyable<T>::value)
+                binary(x);
+            else
+                throw std::invalid_argument("binary output needs a trivially copyable element type");
+            return;
+        }
+        if (!first)
+            write(fmt.separator);
+        text(x);
+    }
+
+    /**
+     * @brief 写完最后一个元素之后调用, 文本模式下写出结尾.
+     *
+     * @param fmt 输出格式.
+     */
+    void finish(const WriteFormat &fmt)
+    {
+        if (!fmt.binary)
+            write(fmt.terminator);
+    }
+
+    /**
+     * @brief 按照 fmt 写出 [first, last) 中的全部元素.
+     *
+     * @param first 起始迭代器.
+     * @param last 结束迭代器.
+     * @param fmt 输出格式.
+     */
+    template <typename Iterator>
+    void range(Iterator first, Iterator last, const WriteFormat &fmt)
+    {
+        for (bool isFirst = true; first != last; ++first, isFirst = false)
+            element(*first, fmt, isFirst);
+        finish(fmt);
+    }
+
+private:
+    static constexpr std::size_t MIN_CAPACITY = 64; /**<! 保证一个数一定能放进剩余空间. */
+
+    std::ostream &out;                  /**<! 底层的输出流. */
+    std::size_t size;                   /**<! 缓冲区大小. */
+    std::unique_ptr<char[]> buffer;     /**<! 缓冲区. */
+    std::size_t used;                   /**<! 已经使用的字节数. */
+    std::unique_ptr<std::ostringstream> fallback; /**<! 格式化其它类型用的流. */
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,249 @@
+#ifndef __SIMD_FIND_MARK__
+#define __SIMD_FIND_MARK__
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMD_FIND_X86 1
+#else
+#define SIMD_FIND_X86 0
+#endif
+
+/**
+ * @brief 在一段连续存放的元素中查找第一个等于 x 的元素. 对 4 字节和 8 字节的整数以及
+ * float, double, 一次比较一整个向量寄存器中的元素 (SSE2 一次 16 字节, AVX2 一次 32 字节),
+ * 再从比较结果的位掩码中取出第一个命中的位置.
+ *
+ * 用哪一套指令是在运行时检测 CPU 之后决定的, 所以同一个可执行文件在不支持 AVX2 的机器上
+ * 也能运行. 其它类型以及非 x86 平台退回到逐个比较的 std::find.
+ *
+ * 比较的结果与 == 完全一致: 整数逐位比较; 浮点数用有序比较, NaN 不等于任何数, 0.0 等于 -0.0.
+ */
+class SimdFind
+{
+public:
+    /**
+     * @brief 可用的指令集.
+     */
+    enum class Level
+    {
+        Scalar, /**<! 逐个比较. */
+        SSE2,   /**<! 一次比较 16 字节. */
+        AVX2    /**<! 一次比较 32 字节. */
+    };
+
+    /**
+     * @brief 当前 CPU 支持的最好的指令集. 只在第一次调用时检测.
+     *
+     * @return Level 指令集.
+     */
+    static Level level()
+    {
+        static const Level detected = detect();
+        return detected;
+    }
+
+    /**
+     * @brief 在 [first, last) 中查找 x, 使用当前 CPU 支持的最好的指令集.
+     *
+     * @param first 第一个元素.
+     * @param last 最后一个元素之后.
+     * @param x 要找的值.
+     * @return const T* 第一个等于 x 的元素, 找不到时为 last.
+     */
+    template <typename T>
+    static const T *find(const T *first, const T *last, const T &x)
+    {
+        return find(first, last, x, level());
+    }
+
+    /**
+     * @brief 在 [first, last) 中查找 x, 使用指定的指令集. 在循环中反复查找时, 可以先取一次
+     * level() 再传进来; 测试时也可以用它比较不同的指令集. 不能指定 CPU 不支持的指令集.
+     *
+     * @param first 第一个元素.
+     * @param last 最后一个元素之后.
+     * @param x 要找的值.
+     * @param lv 指令集.
+     * @return const T* 第一个等于 x 的元素, 找不到时为 last.
+     */
+    template <typename T>
+    static const T *find(const T *first, const T *last, const T &x, Level lv)
+    {
+        std::size_t n = last - first;
+        std::size_t i = n;
+#if SIMD_FIND_X86
+        /// 向量部分只处理整数个向量, 返回命中的下标, 没有命中时返回处理过的元素个数.
+        if constexpr (std::is_same<T, float>::value)
+            i = lv == Level::AVX2 ? floatAvx2(first, n, x) : lv == Level::SSE2 ? floatSse2(first, n, x) : 0;
+        else if constexpr (std::is_same<T, double>::value)
+            i = lv == Level::AVX2 ? doubleAvx2(first, n, x) : lv == Level::SSE2 ? doubleSse2(first, n, x) : 0;
+        else if constexpr (std::is_integral<T>::value && sizeof(T) == 4)
+            i = lv == Level::AVX2 ? int32Avx2(first, n, bits<std::uint32_t>(x))
+                : lv == Level::SSE2 ? int32Sse2(first, n, bits<std::uint32_t>(x)) : 0;
+        else if constexpr (std::is_integral<T>::value && sizeof(T) == 8)
+            i = lv == Level::AVX2 ? int64Avx2(first, n, bits<std::uint64_t>(x))
+                : lv == Level::SSE2 ? int64Sse2(first, n, bits<std::uint64_t>(x)) : 0;
+        else
+            i = 0;
+        if (i < n && first[i] == x)
+            return first + i;
+#else
+        (void)lv;
+        i = 0;
+#endif
+        /// 剩下不足一个向量的尾巴 (或者整段) 逐个比较.
+        return std::find(first + i, last, x);
+    }
+
+private:
+    static Level detect()
+    {
+#if SIMD_FIND_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return Level::AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return Level::SSE2;
+#endif
+        return Level::Scalar;
+    }
+
+    template <typename U, typename T>
+    static U bits(const T &x)
+    {
+        U u;
+        std::memcpy(&u, &x, sizeof(U));
+        return u;
+    }
+
+#if SIMD_FIND_X86
+    /// 下面每个函数只比较前 n / W 个完整的向量 (W 为一个向量中的元素个数).
+    /// 找到时返回命中的下标, 否则返回 n / W * W. 读取用的是不要求对齐的 loadu.
+
+    __attribute__((target("sse2"))) static std::size_t int32Sse2(const void *p, std::size_t n, std::uint32_t x)
+    {
+        const char *s = static_cast<const char *>(p);
+        const __m128i key = _mm_set1_epi32(static_cast<int>(x));
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 4));
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, key)));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) static std::size_t int32Avx2(const void *p, std::size_t n, std::uint32_t x)
+    {
+        const char *s = static_cast<const char *>(p);
+        const __m256i key = _mm256_set1_epi32(static_cast<int>(x));
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i * 4));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, key)));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    /// SSE2 没有 64 位整数的相等比较, 先按 32 位比较, 再要求相邻的两半都相等.
+    __attribute__((target("sse2"))) static std::size_t int64Sse2(const void *p, std::size_t n, std::uint64_t x)
+    {
+        const char *s = static_cast<const char *>(p);
+        const __m128i key = _mm_set1_epi64x(static_cast<long long>(x));
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 8));
+            __m128i eq = _mm_cmpeq_epi32(v, key);
+            eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+            int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) static std::size_t int64Avx2(const void *p, std::size_t n, std::uint64_t x)
+    {
+        const char *s = static_cast<const char *>(p);
+        const __m256i key = _mm256_set1_epi64x(static_cast<long long>(x));
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i * 8));
+            int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, key)));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("sse2"))) static std::size_t floatSse2(const float *p, std::size_t n, float x)
+    {
+        const __m128 key = _mm_set1_ps(x);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p + i), key));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) static std::size_t floatAvx2(const float *p, std::size_t n, float x)
+    {
+        const __m256 key = _mm256_set1_ps(x);
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + i), key, _CMP_EQ_OQ));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("sse2"))) static std::size_t doubleSse2(const double *p, std::size_t n, double x)
+    {
+        const __m128d key = _mm_set1_pd(x);
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), key));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) static std::size_t doubleAvx2(const double *p, std::size_t n, double x)
+    {
+        const __m256d key = _mm256_set1_pd(x);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p + i), key, _CMP_EQ_OQ));
+            if (mask != 0)
+                return i + std::countr_zero(static_cast<unsigned>(mask));
+        }
+        return i;
+    }
+#endif
+};
+
+#else
+// DO NOTHING.
+#endif
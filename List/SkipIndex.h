@@ -0,0 +1,427 @@
+#ifndef __SKIP_INDEX_MARK__
+#define __SKIP_INDEX_MARK__
+
+#include <cstdint>
+#include <bit>
+#include <utility>
+#include "NodePool.h"
+
+/**
+ * @brief 不建立任何索引, 也就是 List 原来的样子. 节点里的 Hook 是空的, 配合
+ * [[no_unique_address]] 不占任何空间. 按位置访问只能从表头一步步走过去, O(n).
+ *
+ * 一个索引策略是以 List 的 NodeBase 为参数的类模板, 需要提供:
+ *   - struct Hook                          放在每个节点 (包括哨兵) 里的数据;
+ *   - static constexpr bool enabled        是否真的维护了索引;
+ *   - void inserted(x)                     x 已经链入表中, 把它加入索引;
+ *   - void erasing(x)                      x 即将从表中摘下, 把它移出索引;
+ *   - static void relocated(from, to)      节点 from 被搬到了 to;
+ *   - void clear()                         丢弃全部索引, 节点里的 Hook 随之失效;
+ *   - void rebuild(head, tail)             表被整体改动之后, 从头重建索引;
+ *   - NodeBase *select(head, k)            第 k 个节点, 头哨兵是第 0 个;
+ *   - int rank(x)                          x 是第几个节点.
+ *
+ * @tparam NodeBase List 节点的链接部分.
+ */
+template <typename NodeBase>
+class NoIndex
+{
+public:
+    struct Hook
+    {
+    };
+
+    static constexpr bool enabled = false; /**<! 没有索引. */
+
+    void inserted(NodeBase *)
+    {
+    }
+
+    void erasing(NodeBase *)
+    {
+    }
+
+    static void relocated(NodeBase *, NodeBase *)
+    {
+    }
+
+    void clear()
+    {
+    }
+
+    void rebuild(NodeBase *, NodeBase *)
+    {
+    }
+
+    /**
+     * @brief 从头哨兵向后走 k 步.
+     *
+     * @param head 头哨兵.
+     * @param k 位置.
+     * @return NodeBase* 第 k 个节点.
+     */
+    NodeBase *select(NodeBase *head, int k) const
+    {
+        for (; k > 0; --k)
+            head = head->next;
+        return head;
+    }
+
+    /**
+     * @brief 从 x 向前走到头哨兵, 数一下走了几步.
+     *
+     * @param x 一个节点.
+     * @return int x 的位置.
+     */
+    int rank(const NodeBase *x) const
+    {
+        int r = 0;
+        for (; x->prev != nullptr; x = x->prev)
+            ++r;
+        return r;
+    }
+};
+
+/**
+ * @brief 跳表式的位置索引. 表本身是跳表的第 0 层; 每个节点以 1/4 的概率出现在第 1 层,
+ * 以 1/16 的概率出现在第 2 层, 依此类推. 第 1 层以上的每一层都是一张双向链表, 每个索引
+ * 节点记下从自己到同一层下一个索引节点在第 0 层上隔了几步 (width).
+ *
+ *   - select(k): 从最高层的表头出发, 在每一层上尽量向右走而不超过 k, 然后下降一层.
+ *   - rank(x):   从 x 出发向左走到第一个更高的节点就上升一层, 把沿途的 width 加起来.
+ *
+ * 两者都是期望 O(log n) 的. 插入和删除先用 rank 求出位置, 再自顶向下找到每一层的前驱,
+ * 修改各层的 width, 也是 O(log n).
+ *
+ * 索引节点从自己的 NodePool 中分配, 所以 clear 只需要整体释放内存池.
+ * 整体改动链接的操作 (splice, merge, sort) 之后用 rebuild 在 O(n) 内重建.
+ *
+ * @tparam NodeBase List 节点的链接部分.
+ */
+template <typename NodeBase>
+class SkipIndex
+{
+private:
+    /**
+     * @brief 第 1 层及以上的索引节点. 各层的表头节点不对应任何数据节点, base 为 nullptr.
+     */
+    struct IndexNode
+    {
+        IndexNode *prev;    /**<! 同一层的前一个索引节点, 表头为 nullptr. */
+        IndexNode *next;    /**<! 同一层的后一个索引节点. */
+        IndexNode *up;      /**<! 同一个节点在上一层的索引节点. */
+        IndexNode *down;    /**<! 同一个节点在下一层的索引节点, 第 1 层为 nullptr. */
+        NodeBase *base;     /**<! 对应的数据节点. */
+        int width;          /**<! 到 next 在第 0 层上的步数. */
+    };
+
+public:
+    /**
+     * @brief 每个节点里只多存一个指针, 指向它在第 1 层的索引节点, 大多数节点的这个指针为空.
+     */
+    struct Hook
+    {
+        IndexNode *up = nullptr;
+    };
+
+    static constexpr bool enabled = true; /**<! 维护索引. */
+
+    SkipIndex() = default;
+
+    SkipIndex(const SkipIndex &) = delete;
+    SkipIndex &operator=(const SkipIndex &) = delete;
+
+    /**
+     * @brief 移动构造函数. 索引节点都在内存池里, 接管内存池即可.
+     *
+     * @param rhs 被移动的索引.
+     */
+    SkipIndex(SkipIndex &&rhs) noexcept
+        : pool{std::move(rhs.pool)}, top{rhs.top}, levels{rhs.levels}, seed{rhs.seed}
+    {
+        rhs.top = nullptr;
+        rhs.levels = 0;
+    }
+
+    /**
+     * @brief 移动赋值. 与 NodePool 一样, 交换之后原来的索引随 rhs 一起释放.
+     *
+     * @param rhs 被移动的索引.
+     * @return SkipIndex& 当前索引.
+     */
+    SkipIndex &operator=(SkipIndex &&rhs) noexcept
+    {
+        pool = std::move(rhs.pool);
+        std::swap(top, rhs.top);
+        std::swap(levels, rhs.levels);
+        return *this;
+    }
+
+    /**
+     * @brief 把已经链入表中的 x 加入索引.
+     *
+     * @param x 新节点.
+     */
+    void inserted(NodeBase *x)
+    {
+        int r = rank(x);
+        int h = randomLevel();
+        while (levels < h)
+            addLevel();
+
+        /// x 之前的节点位置都没有变, 所以可以用旧的 width 找前驱.
+        IndexNode *preds[MAX_LEVEL + 1];
+        int ranks[MAX_LEVEL + 1];
+        findPredecessors(r - 1, preds, ranks);
+
+        IndexNode *below = nullptr;
+        for (int l = 1; l <= levels; ++l)
+        {
+            IndexNode *p = preds[l];
+            if (l <= h)
+            {
+                IndexNode *u = new (pool.allocate()) IndexNode{p, p->next, nullptr, below, x, 0};
+                if (p->next != nullptr)
+                {
+                    u->width = ranks[l] + p->width + 1 - r;
+                    p->next->prev = u;
+                }
+                p->next = u;
+                p->width = r - ranks[l];
+                if (below != nullptr)
+                    below->up = u;
+                else
+                    x->hook.up = u;
+                below = u;
+            }
+            else if (p->next != nullptr)
+                /// 更高的层只是跨过了 x, 距离加一.
+                ++p->width;
+        }
+    }
+
+    /**
+     * @brief 在 x 从表中摘下之前把它移出索引.
+     *
+     * @param x 要删除的节点.
+     */
+    void erasing(NodeBase *x)
+    {
+        if (levels == 0)
+            return;
+        int r = rank(x);
+        IndexNode *preds[MAX_LEVEL + 1];
+        int ranks[MAX_LEVEL + 1];
+        findPredecessors(r - 1, preds, ranks);
+
+        IndexNode *u = x->hook.up;
+        for (int l = 1; l <= levels; ++l)
+        {
+            IndexNode *p = preds[l];
+            if (u != nullptr && p->next == u)
+            {
+                p->width += u->width - 1;
+                p->next = u->next;
+                if (u->next != nullptr)
+                    u->next->prev = p;
+                IndexNode *above = u->up;
+                pool.deallocate(u);
+                u = above;
+            }
+            else if (p->next != nullptr)
+                --p->width;
+        }
+        x->hook.up = nullptr;
+    }
+
+    /**
+     * @brief 节点 from 的内容被搬到了 to (见 List 的内联节点), 让索引节点改指向 to.
+     *
+     * @param from 原来的节点.
+     * @param to 新的节点.
+     */
+    static void relocated(NodeBase *from, NodeBase *to)
+    {
+        to->hook = from->hook;
+        for (IndexNode *u = to->hook.up; u != nullptr; u = u->up)
+            u->base = to;
+    }
+
+    /**
+     * @brief 丢弃全部索引. 之后只能析构这些节点或者 rebuild.
+     *
+     */
+    void clear()
+    {
+        pool.release();
+        top = nullptr;
+        levels = 0;
+    }
+
+    /**
+     * @brief 丢弃旧的索引, 沿着第 0 层从头到尾重新为每个节点抽取层数并建立索引, O(n).
+     *
+     * @param head 头哨兵.
+     * @param tail 尾哨兵.
+     */
+    void rebuild(NodeBase *head, NodeBase *tail)
+    {
+        clear();
+        IndexNode *last[MAX_LEVEL + 1];
+        int lastRank[MAX_LEVEL + 1];
+        int r = 0;
+        for (NodeBase *x = head->next; x != tail; x = x->next)
+        {
+            ++r;
+            x->hook.up = nullptr;
+            int h = randomLevel();
+            while (levels < h)
+            {
+                addLevel();
+                last[levels] = top;
+                lastRank[levels] = 0;
+            }
+            IndexNode *below = nullptr;
+            for (int l = 1; l <= h; ++l)
+            {
+                IndexNode *u = new (pool.allocate()) IndexNode{last[l], nullptr, nullptr, below, x, 0};
+                last[l]->next = u;
+                last[l]->width = r - lastRank[l];
+                last[l] = u;
+                lastRank[l] = r;
+                if (below != nullptr)
+                    below->up = u;
+                else
+                    x->hook.up = u;
+                below = u;
+            }
+        }
+    }
+
+    /**
+     * @brief 找到第 k 个节点. 在每一层上尽量向右走, 最后在第 0 层上补齐剩下的几步.
+     *
+     * @param head 头哨兵, 它是第 0 个节点.
+     * @param k 位置.
+     * @return NodeBase* 第 k 个节点.
+     */
+    NodeBase *select(NodeBase *head, int k) const
+    {
+        int pos = 0;
+        NodeBase *x = head;
+        if (top != nullptr)
+        {
+            IndexNode *u = top;
+            for (;;)
+            {
+                while (u->next != nullptr && pos + u->width <= k)
+                {
+                    pos += u->width;
+                    u = u->next;
+                }
+                if (u->down == nullptr)
+                    break;
+                u = u->down;
+            }
+            if (u->base != nullptr)
+                x = u->base;
+        }
+        for (; pos < k; ++pos)
+            x = x->next;
+        return x;
+    }
+
+    /**
+     * @brief 求 x 的位置. 向左走到第一个出现在更高层的节点就上升一层, 直到遇到表头.
+     *
+     * @param x 一个节点, 可以是尾哨兵.
+     * @return int x 的位置, 头哨兵是 0.
+     */
+    int rank(const NodeBase *x) const
+    {
+        int r = 0;
+        while (x->hook.up == nullptr)
+        {
+            if (x->prev == nullptr)
+                return r;
+            x = x->prev;
+            ++r;
+        }
+        const IndexNode *u = x->hook.up;
+        for (;;)
+        {
+            while (u->up == nullptr)
+            {
+                if (u->prev == nullptr)
+                    return r;
+                u = u->prev;
+                r += u->width;
+            }
+            u = u->up;
+        }
+    }
+
+private:
+    static constexpr int MAX_LEVEL = 16; /**<! 4^16 远大于 int 能表示的表长. */
+
+    NodePool<IndexNode> pool;       /**<! 所有索引节点. */
+    IndexNode *top = nullptr;       /**<! 最高层的表头. */
+    int levels = 0;                 /**<! 当前的层数 (不含第 0 层). */
+    std::uint64_t seed = 0x9E3779B97F4A7C15ull; /**<! 随机数状态. */
+
+    /**
+     * @brief 抽取一个节点的层数: 以 3/4 的概率为 0, 即只在第 0 层; 每多一层概率乘以 1/4.
+     *
+     * @return int 第 0 层以上的层数.
+     */
+    int randomLevel()
+    {
+        /// xorshift64, 足够快, 统计性质对这里也足够好.
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        int h = std::countr_zero(seed | (std::uint64_t{1} << 63)) / 2;
+        return h < MAX_LEVEL ? h : MAX_LEVEL;
+    }
+
+    /**
+     * @brief 在顶上加一层空的表头.
+     *
+     */
+    void addLevel()
+    {
+        IndexNode *u = new (pool.allocate()) IndexNode{nullptr, nullptr, nullptr, top, nullptr, 0};
+        if (top != nullptr)
+            top->up = u;
+        top = u;
+        ++levels;
+    }
+
+    /**
+     * @brief 自顶向下找出每一层中位置不超过 k 的最后一个索引节点.
+     *
+     * @param k 位置.
+     * @param preds 第 l 层的结果存放在 preds[l].
+     * @param ranks preds[l] 的位置.
+     */
+    void findPredecessors(int k, IndexNode **preds, int *ranks) const
+    {
+        IndexNode *u = top;
+        int pos = 0;
+        for (int l = levels; l >= 1; --l)
+        {
+            while (u->next != nullptr && pos + u->width <= k)
+            {
+                pos += u->width;
+                u = u->next;
+            }
+            preds[l] = u;
+            ranks[l] = pos;
+            u = u->down;
+        }
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
@@ -0,0 +1,756 @@
+#ifndef __UNROLLED_LIST_MARK__
+#define __UNROLLED_LIST_MARK__
+
+#include <utility>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <new>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include "SimdFind.h"
+
+/**
+ * @brief 展开链表 (unrolled linked list). 接口与 List 相同, 但每个节点 (称为块, chunk)
+ * 里连续存放最多 N 个元素. 顺序遍历时大部分 ++ 只是下标加一, 元素在内存中也是连续的,
+ * 因此比每个元素一个节点的 List 对缓存友好得多.
+ *
+ * 块满了插入时一分为二; 删除后块中元素少于一半, 并且能和后一个块放进一个块时就合并.
+ * 所以除了最后一个块, 每个块大致保持半满以上.
+ *
+ * 注意: 与 List 不同, 插入和删除可能在块之间搬动元素, 因此会使被修改的块 (以及与它
+ * 分裂或合并的块) 上的迭代器失效. 其他块上的迭代器不受影响.
+ *
+ * @tparam Object 元素类型.
+ * @tparam N 每个块最多存放的元素个数.
+ */
+template <typename Object, int N = 16>
+class UnrolledList
+{
+    static_assert(N >= 2, "a chunk must hold at least two elements");
+
+private:
+    /**
+     * @brief 块的公共部分. 两个哨兵只需要这一部分, 不需要存放元素的空间.
+     */
+    struct ChunkBase
+    {
+        ChunkBase *prev; /**<! 前一个块. */
+        ChunkBase *next; /**<! 后一个块. */
+        int count;       /**<! 块中的元素个数, 哨兵为 0. */
+    };
+
+    /**
+     * @brief 存放元素的块. 元素在 storage 中用 placement new 构造, 只有前 count 个是有效的.
+     */
+    struct Chunk : ChunkBase
+    {
+        alignas(Object) unsigned char storage[N * sizeof(Object)]; /**<! 元素的存储空间. */
+
+        /**
+         * @brief 第 i 个位置的地址, 那里不一定已经构造了元素.
+         *
+         * @param i 下标.
+         * @return void* 地址.
+         */
+        void *place(int i)
+        {
+            return storage + i * sizeof(Object);
+        }
+
+        /**
+         * @brief 第 i 个元素. 调用者保证 i < count.
+         *
+         * @param i 下标.
+         * @return Object& 元素.
+         */
+        Object &at(int i)
+        {
+            return *std::launder(reinterpret_cast<Object *>(place(i)));
+        }
+    };
+
+public:
+    /**
+     * @brief 只读迭代器. 由所在的块和块内下标组成. 指向末尾时固定为 {尾哨兵, 0}.
+     *
+     */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Object;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Object *;
+        using reference = const Object &;
+
+        /**
+         * @brief 默认构造函数.
+         *
+         */
+        const_iterator() : chunk{nullptr}, index{0}
+        {
+        }
+
+        /**
+         * @brief 返回当前元素. 只读.
+         *
+         * @return const Object& 当前元素.
+         */
+        const Object &operator*() const
+        {
+            return retrieve();
+        }
+
+        const Object *operator->() const
+        {
+            return &retrieve();
+        }
+
+        /**
+         * @brief 前置自增. 块内只是下标加一, 到块尾才跳到下一个块.
+         *
+         * @return const_iterator& 下一个元素的迭代器.
+         */
+        const_iterator &operator++()
+        {
+            if (++index == chunk->count)
+            {
+                chunk = chunk->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 后置自增.
+         *
+         * @return const_iterator 当前元素的迭代器.
+         */
+        const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        /**
+         * @brief 前置自减. 块首再减就退到前一个块的最后一个元素.
+         *
+         * @return const_iterator& 上一个元素的迭代器.
+         */
+        const_iterator &operator--()
+        {
+            if (index == 0)
+            {
+                chunk = chunk->prev;
+                index = chunk->count;
+            }
+            --index;
+            return *this;
+        }
+
+        /**
+         * @brief 后置自减.
+         *
+         * @return const_iterator 当前元素的迭代器.
+         */
+        const_iterator operator--(int)
+        {
+            const_iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        /**
+         * @brief 判断两个迭代器是否相等.
+         *
+         * @param rhs 右操作数.
+         * @return true 相等.
+         * @return false 不相等.
+         */
+        bool operator==(const const_iterator &rhs) const
+        {
+            return chunk == rhs.chunk && index == rhs.index;
+        }
+
+        /**
+         * @brief 判断两个迭代器是否不相等.
+         *
+         * @param rhs 右操作数.
+         * @return true 不相等.
+         * @return false 相等.
+         */
+        bool operator!=(const const_iterator &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    protected:
+        ChunkBase *chunk; /**<! 当前块. */
+        int index;        /**<! 块内下标. */
+
+        /**
+         * @brief 返回当前元素.
+         *
+         * @return Object& 当前元素.
+         */
+        Object &retrieve() const
+        {
+            return static_cast<Chunk *>(chunk)->at(index);
+        }
+
+        /**
+         * @brief 内部使用的构造函数.
+         *
+         * @param c 所在的块.
+         * @param i 块内下标.
+         */
+        const_iterator(ChunkBase *c, int i) : chunk{c}, index{i}
+        {
+        }
+
+        friend class UnrolledList<Object, N>;
+    };
+
+    /**
+     * @brief 可写的迭代器. 与 List 一样继承自 const_iterator.
+     *
+     */
+    class iterator : public const_iterator
+    {
+    public:
+        using pointer = Object *;
+        using reference = Object &;
+
+        iterator()
+        {
+        }
+
+        /**
+         * @brief 返回当前元素. 可读可写. 与 List::iterator 一样不区分迭代器本身是否为 const.
+         *
+         * @return Object& 当前元素.
+         */
+        Object &operator*() const
+        {
+            return const_iterator::retrieve();
+        }
+
+        Object *operator->() const
+        {
+            return &const_iterator::retrieve();
+        }
+
+        iterator &operator++()
+        {
+            const_iterator::operator++();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        iterator &operator--()
+        {
+            const_iterator::operator--();
+            return *this;
+        }
+
+        iterator operator--(int)
+        {
+            iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+    protected:
+        iterator(ChunkBase *c, int i) : const_iterator{c, i}
+        {
+        }
+
+        friend class UnrolledList<Object, N>;
+    };
+
+public:
+    /**
+     * @brief 默认构造函数. 构建一张空表.
+     *
+     */
+    UnrolledList() { init( ); }
+
+    /**
+     * @brief 初始化列表构造函数.
+     *
+     * @param il 初始化列表.
+     */
+    UnrolledList(std::initializer_list<Object> il) : UnrolledList()
+    {
+        for (const auto & x : il)
+            push_back(x);
+    }
+
+    /**
+     * @brief 拷贝构造函数.
+     *
+     * @param rhs 右操作对象.
+     */
+    UnrolledList(const UnrolledList &rhs) : UnrolledList()
+    {
+        for (auto & x : rhs)
+            push_back(x);
+    }
+
+    /**
+     * @brief 移动构造函数. 哨兵是对象的一部分, 接管块链之后要把首尾块指回自己的哨兵.
+     *
+     * @param rhs 被移动的表, 之后为空表.
+     */
+    UnrolledList(UnrolledList &&rhs) noexcept : UnrolledList()
+    {
+        adopt(rhs);
+    }
+
+    /**
+     * @brief 析构函数.
+     *
+     */
+    ~UnrolledList()
+    {
+        clear( );
+    }
+
+    /**
+     * @brief 赋值运算符, 与 List 一样采用 copy-and-swap.
+     *
+     * @param copy 右操作对象的副本.
+     * @return UnrolledList& 当前对象.
+     */
+    UnrolledList &operator=(UnrolledList copy)
+    {
+        swap(copy);
+        return *this;
+    }
+
+    /**
+     * @brief 交换两张表的内容.
+     *
+     * @param rhs 另一张表.
+     */
+    void swap(UnrolledList &rhs) noexcept
+    {
+        UnrolledList tmp;
+        tmp.adopt(*this);
+        adopt(rhs);
+        rhs.adopt(tmp);
+    }
+
+    iterator begin()
+    {
+        return { head.next, 0 };
+    }
+
+    const_iterator begin() const
+    {
+        return { head.next, 0 };
+    }
+
+    iterator end()
+    {
+        return { &tail, 0 };
+    }
+
+    const_iterator end() const
+    {
+        return { const_cast<ChunkBase *>(&tail), 0 };
+    }
+
+    /**
+     * @brief 元素总数.
+     *
+     * @return int
+     */
+    int size() const
+    {
+        return theSize;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief 清空表. 每个块只需要 delete 一次.
+     *
+     */
+    void clear()
+    {
+        ChunkBase *c = head.next;
+        while (c != &tail)
+        {
+            ChunkBase *next = c->next;
+            Chunk *ch = static_cast<Chunk *>(c);
+            for (int i = 0; i < ch->count; ++i)
+                ch->at(i).~Object();
+            delete ch;
+            c = next;
+        }
+        init( );
+    }
+
+    Object &front()
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access front of an empty list");
+        return *begin();
+    }
+
+    const Object &front() const
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access front of an empty list");
+        return *begin();
+    }
+
+    Object &back()
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access back of an empty list");
+        return *--end();
+    }
+
+    const Object &back() const
+    {
+        if (empty())
+            throw std::out_of_range("Attempting to access back of an empty list");
+        return *--end();
+    }
+
+    void push_front(const Object &x)
+    {
+        insert(begin(), x);
+    }
+
+    void push_front(Object &&x)
+    {
+        insert(begin(), std::move(x));
+    }
+
+    void push_back(const Object &x)
+    {
+        insert(end(), x);
+    }
+
+    void push_back(Object &&x)
+    {
+        insert(end(), std::move(x));
+    }
+
+    void pop_front()
+    {
+        erase(begin());
+    }
+
+    void pop_back()
+    {
+        erase(--end());
+    }
+
+    /**
+     * @brief 在 itr 之前插入一个左值元素.
+     *
+     * @param itr 插入位置.
+     * @param x 元素.
+     * @return iterator 指向新元素的迭代器.
+     */
+    iterator insert(iterator itr, const Object &x)
+    {
+        return insertAt(itr, x);
+    }
+
+    /**
+     * @brief 在 itr 之前插入一个右值元素.
+     *
+     * @param itr 插入位置.
+     * @param x 元素.
+     * @return iterator 指向新元素的迭代器.
+     */
+    iterator insert(iterator itr, Object &&x)
+    {
+        return insertAt(itr, std::move(x));
+    }
+
+    /**
+     * @brief 删除 itr 指向的元素. 块内后面的元素前移一位, 块变空就释放, 块太空就与后一个块合并.
+     *
+     * @param itr 要删除的元素, 不能是 end().
+     * @return iterator 被删除元素的下一个元素.
+     */
+    iterator erase(iterator itr)
+    {
+        if (itr.chunk == &tail || itr.chunk == &head)
+            return itr;
+        Chunk *c = static_cast<Chunk *>(itr.chunk);
+        int i = itr.index;
+        for (int j = i + 1; j < c->count; ++j)
+            c->at(j - 1) = std::move(c->at(j));
+        c->at(c->count - 1).~Object();
+        --c->count;
+        --theSize;
+
+        if (c->count == 0)
+        {
+            ChunkBase *next = c->next;
+            unlinkChunk(c);
+            return { next, 0 };
+        }
+        ChunkBase *next = c->next;
+        if (c->count < N / 2 && next != &tail && c->count + next->count <= N)
+        {
+            /// 把后一个块的元素全部搬过来, 然后释放它.
+            Chunk *n = static_cast<Chunk *>(next);
+            for (int j = 0; j < n->count; ++j)
+            {
+                ::new (c->place(c->count + j)) Object(std::move(n->at(j)));
+                n->at(j).~Object();
+            }
+            c->count += n->count;
+            unlinkChunk(n);
+        }
+        if (i == c->count)
+            return { c->next, 0 };
+        return { c, i };
+    }
+
+    /**
+     * @brief 删除 [from, to) 的元素. 删除过程中块可能合并, to 会失效,
+     * 所以先数出个数, 再从 from 开始删这么多个.
+     *
+     * @param from 起始位置.
+     * @param to 结束位置.
+     * @return iterator 删除的最后一个元素的下一个元素.
+     */
+    iterator erase(iterator from, iterator to)
+    {
+        int n = 0;
+        for (iterator itr = from; itr != to; ++itr)
+            ++n;
+        while (n-- > 0)
+            from = erase(from);
+        return from;
+    }
+
+    /**
+     * @brief 查找第一个等于 x 的元素. 块内的元素是连续存放的, 所以每个块可以整块交给
+     * SimdFind, 对整数和浮点数一次比较一整个向量. 块越大, 向量比较所占的比例越高.
+     *
+     * @param x 要找的值.
+     * @return iterator 指向第一个等于 x 的元素, 找不到时为 end().
+     */
+    iterator find(const Object &x)
+    {
+        /// 指令集只检测一次, 不要在每个块里重新判断.
+        const SimdFind::Level level = SimdFind::level();
+        for (ChunkBase *c = head.next; c != &tail; c = c->next)
+        {
+            const Object *first = &static_cast<Chunk *>(c)->at(0);
+            const Object *last = first + c->count;
+            const Object *p = SimdFind::find(first, last, x, level);
+            if (p != last)
+                return { c, static_cast<int>(p - first) };
+        }
+        return end( );
+    }
+
+    /**
+     * @brief 查找第一个等于 x 的元素, 只读版本.
+     *
+     * @param x 要找的值.
+     * @return const_iterator 指向第一个等于 x 的元素, 找不到时为 end().
+     */
+    const_iterator find(const Object &x) const
+    {
+        return const_cast<UnrolledList *>(this)->find(x);
+    }
+
+    /**
+     * @brief 打印整个表.
+     *
+     */
+    void printList() const
+    {
+        for (auto it = begin(); it != end(); ++it)
+            std::cout << *it << " ";
+        std::cout << std::endl;
+    }
+
+private:
+    int theSize;     /**<! 元素总数. */
+    ChunkBase head;  /**<! 头哨兵. */
+    ChunkBase tail;  /**<! 尾哨兵. */
+
+    /**
+     * @brief 构建一张空表.
+     *
+     */
+    void init()
+    {
+        theSize = 0;
+        head.prev = nullptr;
+        head.next = &tail;
+        head.count = 0;
+        tail.prev = &head;
+        tail.next = nullptr;
+        tail.count = 0;
+    }
+
+    /**
+     * @brief 接管 rhs 的全部块, rhs 变为空表. 调用前当前表必须为空.
+     *
+     * @param rhs 另一张表.
+     */
+    void adopt(UnrolledList &rhs) noexcept
+    {
+        if (rhs.empty())
+            return;
+        head.next = rhs.head.next;
+        tail.prev = rhs.tail.prev;
+        head.next->prev = &head;
+        tail.prev->next = &tail;
+        theSize = rhs.theSize;
+        rhs.init( );
+    }
+
+    /**
+     * @brief 在块 c 之后新建一个空块.
+     *
+     * @param c 前一个块.
+     * @return Chunk* 新块.
+     */
+    Chunk *newChunkAfter(ChunkBase *c)
+    {
+        Chunk *n = new Chunk;
+        n->count = 0;
+        n->prev = c;
+        n->next = c->next;
+        c->next->prev = n;
+        c->next = n;
+        return n;
+    }
+
+    /**
+     * @brief 把一个已经没有元素的块从链上摘下并释放.
+     *
+     * @param c 要释放的块.
+     */
+    void unlinkChunk(Chunk *c)
+    {
+        c->prev->next = c->next;
+        c->next->prev = c->prev;
+        delete c;
+    }
+
+    /**
+     * @brief 插入. x 可能就是插入位置所在块中的某个元素, 分裂和后移都会改写或析构它,
+     * 这时和 std::vector::insert 一样先把 x 拷贝到一个临时对象里. 只有左值需要这样做,
+     * 而且只在它的地址落在这个块里时才拷贝; 在末尾插入时不会挪动已有的元素, 也不用拷贝.
+     *
+     * @param itr 插入位置.
+     * @param x 元素, 左值或右值.
+     * @return iterator 指向新元素的迭代器.
+     */
+    template <typename X>
+    iterator insertAt(iterator itr, X &&x)
+    {
+        if constexpr (std::is_lvalue_reference<X>::value)
+        {
+            if (itr.chunk != &tail && owns(static_cast<Chunk *>(itr.chunk), std::addressof(x)))
+            {
+                Object tmp(x);
+                return placeAt(itr, std::move(tmp));
+            }
+        }
+        return placeAt(itr, std::forward<X>(x));
+    }
+
+    /**
+     * @brief x 是否放在块 c 的存储空间里.
+     *
+     * @param c 块.
+     * @param x 元素的地址.
+     */
+    static bool owns(Chunk *c, const Object *x)
+    {
+        auto p = reinterpret_cast<std::uintptr_t>(x);
+        auto begin = reinterpret_cast<std::uintptr_t>(c->storage);
+        return p >= begin && p < begin + sizeof(c->storage);
+    }
+
+    /**
+     * @brief 插入的实际实现. 先确定落在哪个块的哪个位置, 块满了就对半分裂,
+     * 然后把该位置之后的元素后移一位, 腾出位置放新元素. x 不能是这个块中的元素.
+     *
+     * @param itr 插入位置.
+     * @param x 元素, 左值或右值.
+     * @return iterator 指向新元素的迭代器.
+     */
+    template <typename X>
+    iterator placeAt(iterator itr, X &&x)
+    {
+        ChunkBase *cb = itr.chunk;
+        int i = itr.index;
+        if (cb == &tail)
+        {
+            /// 在末尾插入: 最后一个块还有空位就放进去, 否则新开一块.
+            cb = tail.prev;
+            if (cb == &head || cb->count == N)
+                cb = newChunkAfter(cb);
+            i = cb->count;
+        }
+        else if (cb->count == N)
+        {
+            /// 块满了, 把后一半搬到新块中.
+            Chunk *left = static_cast<Chunk *>(cb);
+            Chunk *right = newChunkAfter(left);
+            const int half = N / 2;
+            for (int j = half; j < N; ++j)
+            {
+                ::new (right->place(j - half)) Object(std::move(left->at(j)));
+                left->at(j).~Object();
+            }
+            right->count = N - half;
+            left->count = half;
+            if (i > half)
+            {
+                cb = right;
+                i -= half;
+            }
+        }
+
+        Chunk *c = static_cast<Chunk *>(cb);
+        if (i == c->count)
+            ::new (c->place(i)) Object(std::forward<X>(x));
+        else
+        {
+            ::new (c->place(c->count)) Object(std::move(c->at(c->count - 1)));
+            for (int j = c->count - 1; j > i; --j)
+                c->at(j) = std::move(c->at(j - 1));
+            c->at(i) = std::forward<X>(x);
+        }
+        ++c->count;
+        ++theSize;
+        return { c, i };
+    }
+};
+
+#else
+// DO NOTHING.
+#endif
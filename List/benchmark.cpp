@@ -0,0 +1,777 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include "List.h"
+#include "UnrolledList.h"
+#include "ConcurrentQueue.h"
+#include "IntrusiveList.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <utility>
+
+/**
+ * @brief 计时工具. 运行 f 一次，返回耗时 (毫秒).
+ *
+ * @param f 被计时的函数.
+ * @return double 耗时.
+ */
+template <typename F>
+double timeIt(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
+}
+
+/**
+ * @brief 防止编译器把结果优化掉.
+ *
+ */
+volatile long long sink;
+
+/**
+ * @brief 插入/删除吞吐量测试: 尾部插入 n 个元素后从头部全部删除;
+ * 再维持一个长度为 n 的队列做 n 次 push_back + pop_front;
+ * 最后在表的中间反复插入并删除.
+ *
+ * @tparam L 被测试的 List 类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void churn(int n, const char *name)
+{
+    double fill = timeIt([n] {
+        L list;
+        for (int i = 0; i < n; ++i)
+            list.push_back(i);
+        while (!list.empty())
+            list.pop_front();
+    });
+
+    L queue;
+    for (int i = 0; i < n; ++i)
+        queue.push_back(i);
+    double fifo = timeIt([n, &queue] {
+        for (int i = 0; i < n; ++i)
+        {
+            queue.push_back(i);
+            queue.pop_front();
+        }
+    });
+
+    double middle = timeIt([n, &queue] {
+        auto mid = queue.begin();
+        for (int i = 0; i < n / 2; ++i)
+            ++mid;
+        for (int i = 0; i < n; ++i)
+            mid = queue.erase(queue.insert(mid, i));
+        sink = *mid;
+    });
+
+    std::cout << name << "\tn = " << n
+              << "\tfill/drain: " << fill << " ms"
+              << "\tqueue churn: " << fifo << " ms"
+              << "\tmiddle insert/erase: " << middle << " ms" << std::endl;
+}
+
+void benchAllocator()
+{
+    std::cout << "== NodePool vs global new ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        churn<List<int, NewAllocator>>(n, "new/delete");
+        churn<List<int, NodePool>>(n, "NodePool  ");
+    }
+}
+
+/**
+ * @brief 短表测试: 反复构造 count 张长度为 len 的表, 遍历后析构.
+ *
+ * @tparam L 被测试的 List 类型.
+ * @param count 表的张数.
+ * @param len 每张表的长度.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void shortLists(int count, int len, const char *name)
+{
+    double t = timeIt([count, len] {
+        long long sum = 0;
+        for (int k = 0; k < count; ++k)
+        {
+            L list;
+            for (int i = 0; i < len; ++i)
+                list.push_back(i);
+            for (int x : list)
+                sum += x;
+        }
+        sink = sum;
+    });
+
+    std::cout << name << "\tlen = " << len << "\tx" << count << ": " << t << " ms" << std::endl;
+}
+
+void benchSmall()
+{
+    std::cout << "== SmallList vs List (short lists) ==" << std::endl;
+    for (int len : {0, 2, 8, 32})
+    {
+        shortLists<List<int, NewAllocator>>(1000000, len, "new/delete  ");
+        shortLists<List<int, NodePool>>(1000000, len, "NodePool    ");
+        shortLists<SmallList<int, 8>>(1000000, len, "SmallList<8>");
+    }
+}
+
+/**
+ * @brief 清空与整段删除测试: 建一张 n 个元素的表, 删掉中间一半, 再清空.
+ *
+ * @tparam L 被测试的 List 类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void bulkErase(int n, const char *name)
+{
+    L list;
+    for (int i = 0; i < n; ++i)
+        list.push_back(i);
+    auto from = list.begin();
+    auto to = list.begin();
+    for (int i = 0; i < n / 4; ++i)
+        ++from;
+    for (int i = 0; i < 3 * n / 4; ++i)
+        ++to;
+    double range = timeIt([&] { list.erase(from, to); });
+    double clear = timeIt([&] { list.clear(); });
+
+    std::cout << name << "\tn = " << n
+              << "\trange erase: " << range << " ms"
+              << "\tclear: " << clear << " ms" << std::endl;
+}
+
+void benchBulkErase()
+{
+    std::cout << "== range erase / clear ==" << std::endl;
+    for (int n = 10000; n <= 10000000; n *= 10)
+    {
+        bulkErase<List<int, NewAllocator>>(n, "new/delete");
+        bulkErase<List<int, NodePool>>(n, "NodePool  ");
+    }
+}
+
+/**
+ * @brief 顺序遍历、中间插入和中间删除测试. 中间插入/删除先从头走到表的中间,
+ * 再在那里连续操作 ops 次.
+ *
+ * @tparam L 被测试的表类型.
+ * @param n 元素个数.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void scanInsertErase(int n, const char *name)
+{
+    const int ops = 1000;
+    L list;
+    for (int i = 0; i < n; ++i)
+        list.push_back(i);
+
+    double scan = timeIt([&] {
+        long long sum = 0;
+        for (int x : list)
+            sum += x;
+        sink = sum;
+    });
+
+    double insert = timeIt([&] {
+        auto it = list.begin();
+        for (int i = 0; i < n / 2; ++i)
+            ++it;
+        for (int i = 0; i < ops; ++i)
+            it = list.insert(it, i);
+    });
+
+    double erase = timeIt([&] {
+        auto it = list.begin();
+        for (int i = 0; i < n / 2; ++i)
+            ++it;
+        for (int i = 0; i < ops; ++i)
+            it = list.erase(it);
+    });
+
+    std::cout << name << "\tn = " << n
+              << "\tscan: " << scan << " ms"
+              << "\tmiddle insert x" << ops << ": " << insert << " ms"
+              << "\tmiddle erase x" << ops << ": " << erase << " ms" << std::endl;
+}
+
+void benchUnrolled()
+{
+    std::cout << "== UnrolledList vs List ==" << std::endl;
+    for (int n = 1000; n <= 10000000; n *= 10)
+    {
+        scanInsertErase<List<int>>(n, "List           ");
+        scanInsertErase<UnrolledList<int, 16>>(n, "UnrolledList<16>");
+        scanInsertErase<UnrolledList<int, 64>>(n, "UnrolledList<64>");
+    }
+}
+
+/**
+ * @brief 用互斥锁保护的 List, 也就是原来当作工作队列的用法.
+ *
+ */
+class LockedQueue
+{
+public:
+    void push(int x)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        list.push_back(x);
+    }
+
+    bool try_pop(int &out)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (list.empty())
+            return false;
+        out = list.front();
+        list.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m;
+    List<int> list;
+};
+
+/**
+ * @brief 多生产者多消费者吞吐量测试: producers 个线程共入队 n 个元素,
+ * consumers 个线程把它们全部取出.
+ *
+ * @tparam Q 队列类型.
+ * @param n 元素总数.
+ * @param producers 生产者个数.
+ * @param consumers 消费者个数.
+ * @param name 输出时的名字.
+ */
+template <typename Q>
+void producerConsumer(int n, int producers, int consumers, const char *name)
+{
+    Q q;
+    std::atomic<int> popped{0};
+    long long total = 0;
+    std::mutex totalMutex;
+    double t = timeIt([&] {
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+            threads.emplace_back([&q, p, n, producers] {
+                for (int i = p; i < n; i += producers)
+                    q.push(i);
+            });
+        for (int c = 0; c < consumers; ++c)
+            threads.emplace_back([&] {
+                long long sum = 0;
+                int x;
+                while (popped.load(std::memory_order_relaxed) < n)
+                    if (q.try_pop(x))
+                    {
+                        sum += x;
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total += sum;
+            });
+        for (auto &th : threads)
+            th.join();
+    });
+    sink = total;
+
+    std::cout << name << "\t" << producers << "P/" << consumers << "C"
+              << "\t" << t << " ms"
+              << "\t" << n / t / 1000 << " Mops/s" << std::endl;
+}
+
+void benchConcurrent()
+{
+    std::cout << "== ConcurrentQueue vs mutex + List ==" << std::endl;
+    const int n = 2000000;
+    int maxThreads = std::max(2u, std::thread::hardware_concurrency());
+    for (int k = 1; 2 * k <= maxThreads || k == 1; k *= 2)
+    {
+        producerConsumer<LockedQueue>(n, k, k, "mutex + List   ");
+        producerConsumer<ConcurrentQueue<int>>(n, k, k, "ConcurrentQueue");
+    }
+}
+
+/**
+ * @brief 移动构造函数可能抛出异常的 List, 模拟修改之前的情形.
+ * std::vector 扩容时为了保证强异常安全, 对这样的元素只会拷贝.
+ *
+ */
+struct ThrowingMoveList : List<int>
+{
+    using List<int>::List;
+    ThrowingMoveList(const ThrowingMoveList &) = default;
+    ThrowingMoveList(ThrowingMoveList &&rhs) noexcept(false) : List<int>(std::move(rhs))
+    {
+    }
+};
+
+/**
+ * @brief 不预留空间, 向 vector 中逐个加入 count 张长度为 len 的表.
+ *
+ * @tparam L 被测试的 List 类型.
+ * @param count 表的张数.
+ * @param len 每张表的长度.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void vectorGrowth(int count, int len, const char *name)
+{
+    L proto;
+    for (int i = 0; i < len; ++i)
+        proto.push_back(i);
+    double t = timeIt([&] {
+        std::vector<L> v;
+        for (int k = 0; k < count; ++k)
+            v.push_back(proto);
+        sink = v.back().back();
+    });
+
+    std::cout << name << "\tlists = " << count << "\tlen = " << len
+              << "\t" << t << " ms"
+              << "\t" << t * 1e6 / count << " ns/list" << std::endl;
+}
+
+void benchVectorGrowth()
+{
+    std::cout << "== vector<List> growth ==" << std::endl;
+    for (int count = 1000; count <= 1000000; count *= 10)
+    {
+        vectorGrowth<ThrowingMoveList>(count, 16, "copy on growth");
+        vectorGrowth<List<int>>(count, 16, "noexcept move ");
+    }
+}
+
+/**
+ * @brief 按位置访问测试: 建一张 n 个元素的表, 然后随机做 ops 次 at(k) 和 index_of.
+ *
+ * @tparam L 被测试的 List 类型.
+ * @param n 元素个数.
+ * @param ops 查询次数.
+ * @param name 输出时的名字.
+ */
+template <typename L>
+void positional(int n, int ops, const char *name)
+{
+    L list;
+    double build = timeIt([&] {
+        for (int i = 0; i < n; ++i)
+            list.push_back(i);
+    });
+
+    unsigned seed = 1;
+    double at = timeIt([&] {
+        long long sum = 0;
+        for (int i = 0; i < ops; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            sum += list.at((seed >> 8) % n);
+        }
+        sink = sum;
+    });
+
+    std::vector<typename L::iterator> its;
+    for (int i = 0; i < ops; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        its.push_back(list.advance(list.begin(), (seed >> 8) % n));
+    }
+    double indexOf = timeIt([&] {
+        long long sum = 0;
+        for (auto &it : its)
+            sum += list.index_of(it);
+        sink = sum;
+    });
+
+    std::cout << name << "\tn = " << n
+              << "\tbuild: " << build << " ms"
+              << "\tat x" << ops << ": " << at << " ms"
+              << "\tindex_of x" << ops << ": " << indexOf << " ms" << std::endl;
+}
+
+void benchIndex()
+{
+    std::cout << "== IndexedList vs List (positional access) ==" << std::endl;
+    for (int n = 1000; n <= 1000000; n *= 10)
+    {
+        positional<List<int>>(n, 1000, "List       ");
+        positional<IndexedList<int>>(n, 1000, "IndexedList");
+    }
+}
+
+/**
+ * @brief 输出测试: 把 n 个 int 分别用 printList, write_to 的文本模式和二进制模式写出.
+ * std::cout 暂时被重定向到 /dev/null, 所以测到的是格式化和写操作本身的开销.
+ *
+ * @param n 元素个数.
+ */
+void output(int n)
+{
+    List<int> list;
+    for (int i = 0; i < n; ++i)
+        list.push_back(i * 7919 - n);
+
+    std::ofstream devnull("/dev/null");
+    std::streambuf *saved = std::cout.rdbuf(devnull.rdbuf());
+    double print = timeIt([&] { list.printList(); });
+    double text = timeIt([&] { list.write_to(std::cout); });
+    double binary = timeIt([&] { list.write_to(std::cout, {"", "", true}); });
+    std::cout.rdbuf(saved);
+
+    std::cout << "n = " << n
+              << "\tprintList: " << print << " ms"
+              << "\twrite_to (text): " << text << " ms"
+              << "\twrite_to (binary): " << binary << " ms" << std::endl;
+}
+
+void benchOutput()
+{
+    std::cout << "== printList vs write_to ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        output(n);
+}
+
+/**
+ * @brief 查找测试: 在 n 个元素中查找 lookups 个随机的值, 其中一半不存在 (要扫描整张表).
+ * 比较 List 上的 std::find, UnrolledList 上的 std::find 和 UnrolledList::find (按块向量比较),
+ * 以及在一个连续数组上分别用三种指令集的 SimdFind, 作为按块存放所能达到的上限.
+ *
+ * @tparam T 元素类型.
+ * @param n 元素个数.
+ * @param lookups 查找次数.
+ * @param name 输出时的名字.
+ */
+template <typename T>
+void searching(int n, int lookups, const char *name)
+{
+    List<T> list;
+    UnrolledList<T, 16> small;
+    UnrolledList<T, 64> large;
+    std::vector<T> array;
+    for (int i = 0; i < n; ++i)
+    {
+        T x = static_cast<T>(i);
+        list.push_back(x);
+        small.push_back(x);
+        large.push_back(x);
+        array.push_back(x);
+    }
+    std::vector<T> keys;
+    unsigned seed = 1;
+    for (int i = 0; i < lookups; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        keys.push_back(static_cast<T>(i % 2 == 0 ? (seed >> 8) % n : n + i));
+    }
+
+    auto run = [&keys](auto find) {
+        return timeIt([&] {
+            long long hits = 0;
+            for (const T &k : keys)
+                hits += find(k);
+            sink = hits;
+        });
+    };
+    double onList = run([&](const T &k) { return std::find(list.begin(), list.end(), k) != list.end(); });
+    double onChunks = run([&](const T &k) { return std::find(large.begin(), large.end(), k) != large.end(); });
+    double small16 = run([&](const T &k) { return small.find(k) != small.end(); });
+    double large64 = run([&](const T &k) { return large.find(k) != large.end(); });
+
+    std::cout << name << "\tn = " << n << "\tx" << lookups
+              << "\tList std::find: " << onList << " ms"
+              << "\tUnrolledList<64> std::find: " << onChunks << " ms"
+              << "\tUnrolledList<16>::find: " << small16 << " ms"
+              << "\tUnrolledList<64>::find: " << large64 << " ms" << std::endl;
+
+    const char *levels[] = {"scalar", "SSE2", "AVX2"};
+    std::cout << name << "\tcontiguous array:";
+    for (int lv = 0; lv <= static_cast<int>(SimdFind::level()); ++lv)
+    {
+        const T *first = array.data(), *last = first + n;
+        double t = run([&](const T &k) {
+            return SimdFind::find(first, last, k, static_cast<SimdFind::Level>(lv)) != last;
+        });
+        std::cout << "\t" << levels[lv] << ": " << t << " ms";
+    }
+    std::cout << std::endl;
+}
+
+void benchFind()
+{
+    std::cout << "== find over packed chunks ==" << std::endl;
+    searching<int>(1000000, 100, "int   ");
+    searching<double>(1000000, 100, "double");
+}
+
+/**
+ * @brief 拷贝测试: 对一张 n 个元素的表, 比较逐个 push_back 的拷贝 (原来拷贝构造函数的做法),
+ * 拷贝构造 (一次预留全部节点), 以及给一张等长的表拷贝赋值 (直接复用已有的节点).
+ *
+ * @tparam Object 元素类型.
+ * @param n 元素个数.
+ * @param make 生成第 i 个元素.
+ * @param name 输出时的名字.
+ */
+template <typename Object, typename Make>
+void copying(int n, Make make, const char *name)
+{
+    List<Object> src;
+    for (int i = 0; i < n; ++i)
+        src.push_back(make(i));
+
+    double pushBack = timeIt([&] {
+        List<Object> copy;
+        for (const auto &x : src)
+            copy.push_back(x);
+        sink = copy.size();
+    });
+    double construct = timeIt([&] {
+        List<Object> copy(src);
+        sink = copy.size();
+    });
+    List<Object> target(src);
+    double assign = timeIt([&] {
+        target = src;
+        sink = target.size();
+    });
+
+    std::cout << name << "\tn = " << n
+              << "\tpush_back loop: " << pushBack << " ms"
+              << "\tcopy ctor: " << construct << " ms"
+              << "\tcopy assign: " << assign << " ms" << std::endl;
+}
+
+void benchCopy()
+{
+    std::cout << "== copying a List ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        copying<int>(n, [](int i) { return i; }, "int   ");
+        copying<std::string>(n, [](int i) { return "element #" + std::to_string(i); }, "string");
+    }
+}
+
+/**
+ * @brief 侵入式链表测试中的对象. 对象都放在调用者自己的数组里, 挂钩就在对象身上.
+ */
+struct Item : IntrusiveHook<>
+{
+    int id;
+    char payload[48]; /**<! 让对象大小接近实际使用中的结构体. */
+};
+
+/**
+ * @brief LRU 式的使用场景: n 个对象全部挂到表上, 然后做 ops 次 "访问": 随机取一个对象,
+ * 把它从原来的位置删掉再挂到表尾; 最后从头到尾遍历一遍对象的 id 求和.
+ * 节点式的 List 只能存对象的指针, 为了 O(1) 删除还要另外为每个对象记住它的迭代器,
+ * 每次访问都要释放一个节点再分配一个节点; IntrusiveList 只改几个指针.
+ *
+ * @param n 对象个数.
+ * @param ops 访问次数.
+ */
+void touching(int n, int ops)
+{
+    std::vector<Item> items(n);
+    for (int i = 0; i < n; ++i)
+        items[i].id = i;
+    std::vector<int> picks(ops);
+    unsigned seed = 1;
+    for (auto &x : picks)
+    {
+        seed = seed * 1103515245 + 12345;
+        x = (seed >> 8) % n;
+    }
+
+    List<Item *> owning;
+    std::vector<List<Item *>::iterator> where(n);
+    double owningLink = timeIt([&] {
+        for (int i = 0; i < n; ++i)
+        {
+            owning.push_back(&items[i]);
+            where[i] = --owning.end();
+        }
+    });
+    double owningTouch = timeIt([&] {
+        for (int i : picks)
+        {
+            owning.erase(where[i]);
+            owning.push_back(&items[i]);
+            where[i] = --owning.end();
+        }
+    });
+    double owningScan = timeIt([&] {
+        long long sum = 0;
+        for (const Item *p : owning)
+            sum += p->id;
+        sink = sum;
+    });
+
+    IntrusiveList<Item> intrusive;
+    double intrusiveLink = timeIt([&] {
+        for (auto &x : items)
+            intrusive.push_back(x);
+    });
+    double intrusiveTouch = timeIt([&] {
+        for (int i : picks)
+        {
+            intrusive.erase(items[i]);
+            intrusive.push_back(items[i]);
+        }
+    });
+    double intrusiveScan = timeIt([&] {
+        long long sum = 0;
+        for (const Item &x : intrusive)
+            sum += x.id;
+        sink = sum;
+    });
+
+    std::cout << "List<Item *> \tn = " << n << "\tlink: " << owningLink << " ms"
+              << "\ttouch x" << ops << ": " << owningTouch << " ms"
+              << "\tscan: " << owningScan << " ms" << std::endl;
+    std::cout << "IntrusiveList\tn = " << n << "\tlink: " << intrusiveLink << " ms"
+              << "\ttouch x" << ops << ": " << intrusiveTouch << " ms"
+              << "\tscan: " << intrusiveScan << " ms" << std::endl;
+}
+
+void benchIntrusive()
+{
+    std::cout << "== IntrusiveList vs node-owning List ==" << std::endl;
+    for (int n = 10000; n <= 1000000; n *= 10)
+        touching(n, 1000000);
+}
+
+/**
+ * @brief 用一个真正的 std::initializer_list 构造 List. 初始化列表的长度必须在编译期确定,
+ * 所以借助 index_sequence 把 values 的前 sizeof...(I) 个元素展开成一个花括号列表.
+ *
+ * @param values 元素.
+ * @return List<int> 构造好的表.
+ */
+template <std::size_t... I>
+List<int> fromInitializerList(const std::vector<int> &values, std::index_sequence<I...>)
+{
+    return List<int>{values[I]...};
+}
+
+/**
+ * @brief 启动时重建表的测试: 先把 n 个 int 保存为快照, 再分别用初始化列表构造函数, push_back 循环,
+ * 从文本文件逐个读入再 push_back, 以及 load_mapped 重建. 初始化列表只能在编译期定长,
+ * 因此用 INIT 个元素一组, 重复构造 n / INIT 次.
+ *
+ * @param n 元素个数.
+ */
+void startup(int n)
+{
+    constexpr std::size_t INIT = 512;
+    std::vector<int> values;
+    for (int i = 0; i < n; ++i)
+        values.push_back(i * 7919 - n);
+    List<int> original;
+    for (int x : values)
+        original.push_back(x);
+    const char *snapshot = "bench_snapshot.tmp";
+    const char *textFile = "bench_text.tmp";
+    original.save(snapshot);
+    {
+        std::ofstream out(textFile);
+        original.write_to(out);
+    }
+
+    double init = timeIt([&] {
+        for (int k = 0; k < n / (int)INIT; ++k)
+        {
+            List<int> list = fromInitializerList(values, std::make_index_sequence<INIT>());
+            sink = list.back();
+        }
+    });
+    double push = timeIt([&] {
+        List<int> list;
+        for (int x : values)
+            list.push_back(x);
+        sink = list.back();
+    });
+    double parse = timeIt([&] {
+        std::ifstream in(textFile);
+        List<int> list;
+        int x;
+        while (in >> x)
+            list.push_back(x);
+        sink = list.back();
+    });
+    double mapped = timeIt([&] {
+        List<int> list;
+        list.load_mapped(snapshot);
+        sink = list.back();
+    });
+    std::remove(snapshot);
+    std::remove(textFile);
+
+    std::cout << "n = " << n
+              << "\tinitializer_list: " << init << " ms"
+              << "\tpush_back loop: " << push << " ms"
+              << "\tparse text + push_back: " << parse << " ms"
+              << "\tload_mapped: " << mapped << " ms" << std::endl;
+}
+
+void benchStartup()
+{
+    std::cout << "== rebuilding a List at startup ==" << std::endl;
+    for (int n = 100000; n <= 10000000; n *= 10)
+        startup(n);
+}
+
+/**
+ * @brief 用法: ./benchmark [suite]. 不带参数时运行全部测试.
+ *
+ */
+int main(int argc, char *argv[])
+{
+    const char *suite = argc > 1 ? argv[1] : "all";
+    bool all = std::strcmp(suite, "all") == 0;
+
+    if (all || std::strcmp(suite, "alloc") == 0)
+        benchAllocator();
+    if (all || std::strcmp(suite, "small") == 0)
+        benchSmall();
+    if (all || std::strcmp(suite, "erase") == 0)
+        benchBulkErase();
+    if (all || std::strcmp(suite, "unrolled") == 0)
+        benchUnrolled();
+    if (all || std::strcmp(suite, "vector") == 0)
+        benchVectorGrowth();
+    if (all || std::strcmp(suite, "index") == 0)
+        benchIndex();
+    if (all || std::strcmp(suite, "output") == 0)
+        benchOutput();
+    if (all || std::strcmp(suite, "find") == 0)
+        benchFind();
+    if (all || std::strcmp(suite, "copy") == 0)
+        benchCopy();
+    if (all || std::strcmp(suite, "intrusive") == 0)
+        benchIntrusive();
+    if (all || std::strcmp(suite, "load") == 0)
+        benchStartup();
+    if (all || std::strcmp(suite, "concurrent") == 0)
+        benchConcurrent();
+
+    return 0;
+}